@@ -53,13 +53,17 @@ namespace color_core
         }
 
         Color operator+(const Color& rhs) {
-            return Color(values[0] + rhs.R(), values[1] + rhs.G(), values[2] + rhs.B(), std::min(values[3] + rhs.Alpha(), 1.0));
+            return Color(values[0] + rhs.values[0], values[1] + rhs.values[1], values[2] + rhs.values[2],
+                         std::min(values[3] + rhs.values[3], 1.0));
         }
 
+        /*!
+         * Add the red, green and blue values of \p rhs, without truncating them, so samples can be summed up
+         */
         void operator+=(const Color& rhs) {
-            values[0] += rhs.R();
-            values[1] += rhs.G();
-            values[2] += rhs.B();
+            values[0] += rhs.values[0];
+            values[1] += rhs.values[1];
+            values[2] += rhs.values[2];
         }
 
         void fromJson(const nlohmann::json& json_object)
@@ -115,5 +119,10 @@ namespace color_core
         [[nodiscard]] int B() const { return static_cast<int>(values[2]); }
 
         [[nodiscard]] double Alpha() const { return static_cast<int>(values[3]); }
+
+        /*!
+         * @return the red, green, blue and alpha values without truncating them, for accumulating samples
+         */
+        [[nodiscard]] const std::array<double, 4>& rgba() const { return values; }
     };
 }
\ No newline at end of file
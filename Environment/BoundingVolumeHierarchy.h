@@ -0,0 +1,536 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <memory>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <stdexcept>
+
+#include "LinearAlgebraTypeTraits.h"
+#include "BoundingBox.h"
+#include "Ray.h"
+#include "RayPacket.h"
+#include "SimdPack.h"
+#include "Geometry.h"
+#include "BinaryStream.h"
+
+namespace environment
+{
+    using namespace linear_algebra_core;
+    using namespace geometry;
+
+    /*!
+     * Bounding volume hierarchy over bounded geometry, built top down using a binned surface area heuristic.
+     * Nodes are stored depth first in a flat array: the left child of an interior node immediately follows it.
+     * Leaves refer to the elements of the geometry (see Geometry::getElementCount) by the index of the geometry in the
+     * container the hierarchy was built from and the index of the element within it.
+     */
+    template<IsFloatingPoint value_type>
+    class BoundingVolumeHierarchy
+    {
+    public:
+        using Geometry_Ptr = std::shared_ptr<Geometry<value_type>>;
+        using Ray_3 = Ray<3, value_type>;
+        using Point_3 = Point_X<3, value_type>;
+        using Vector_3 = Vector_X<3, value_type>;
+        using BoundingBox_3 = BoundingBox<3, value_type>;
+
+    private:
+        static constexpr size_t number_of_bins = 16;
+        // in batches, see build
+        static constexpr size_t max_leaf_size = 4;
+        static constexpr size_t max_depth = 64;
+        // relative cost of visiting a node compared to intersecting a single primitive
+        static constexpr value_type traversal_cost = 1.0;
+
+        struct Node
+        {
+            BoundingBox_3 bounds;
+            // for leaves, the index of the first primitive. for interior nodes, the index of the right child.
+            uint32_t offset = 0;
+            // number of primitives in a leaf, 0 for interior nodes
+            uint32_t count = 0;
+        };
+
+        struct BuildEntry
+        {
+            BoundingBox_3 bounds;
+            Point_3 centroid;
+            ElementReference reference;
+        };
+
+        std::vector<Node> m_nodes;
+        std::vector<ElementReference> m_primitives;
+        // number of primitives in a leaf that are intersected together, see build
+        size_t m_batch_width = 1;
+
+        uint32_t buildRecursive(std::vector<BuildEntry>& entries, size_t begin, size_t end, size_t depth)
+        {
+            auto node_index = static_cast<uint32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+
+            BoundingBox_3 bounds, centroid_bounds;
+            for(size_t i = begin; i < end; i++) {
+                bounds.expand(entries[i].bounds);
+                centroid_bounds.expand(entries[i].centroid);
+            }
+            m_nodes[node_index].bounds = bounds;
+
+            size_t count = end - begin;
+            auto makeLeaf = [&]() {
+                m_nodes[node_index].offset = static_cast<uint32_t>(m_primitives.size());
+                m_nodes[node_index].count = static_cast<uint32_t>(count);
+                for(size_t i = begin; i < end; i++) {
+                    m_primitives.push_back(entries[i].reference);
+                }
+                return node_index;
+            };
+
+            if(count == 1 || depth >= max_depth) {
+                return makeLeaf();
+            }
+
+            // find the cheapest bin boundary over all three axes
+            value_type best_cost = std::numeric_limits<value_type>::max();
+            size_t best_axis = 0;
+            size_t best_split = 0;
+            Vector_3 centroid_extent = centroid_bounds.getExtent();
+            for(size_t axis = 0; axis < 3; axis++) {
+                if(centroid_extent[axis] <= 0) {
+                    continue;
+                }
+                std::array<BoundingBox_3, number_of_bins> bin_bounds{};
+                std::array<size_t, number_of_bins> bin_counts{};
+                value_type scale = static_cast<value_type>(number_of_bins) / centroid_extent[axis];
+                for(size_t i = begin; i < end; i++) {
+                    size_t bin = getBin(entries[i].centroid[axis], centroid_bounds.getMin()[axis], scale);
+                    bin_counts[bin]++;
+                    bin_bounds[bin].expand(entries[i].bounds);
+                }
+
+                // sweep from the right to get the cost of everything right of each boundary
+                std::array<value_type, number_of_bins> right_costs{};
+                BoundingBox_3 right_bounds;
+                size_t right_count = 0;
+                for(size_t bin = number_of_bins - 1; bin > 0; bin--) {
+                    right_bounds.expand(bin_bounds[bin]);
+                    right_count += bin_counts[bin];
+                    right_costs[bin] = right_bounds.getSurfaceArea() * static_cast<value_type>(right_count);
+                }
+
+                BoundingBox_3 left_bounds;
+                size_t left_count = 0;
+                for(size_t split = 1; split < number_of_bins; split++) {
+                    left_bounds.expand(bin_bounds[split - 1]);
+                    left_count += bin_counts[split - 1];
+                    if(left_count == 0 || left_count == count) {
+                        continue;
+                    }
+                    value_type cost = left_bounds.getSurfaceArea() * static_cast<value_type>(left_count) + right_costs[split];
+                    if(cost < best_cost) {
+                        best_cost = cost;
+                        best_axis = axis;
+                        best_split = split;
+                    }
+                }
+            }
+
+            // every centroid is in the same spot, there's no way to separate them
+            if(best_split == 0) {
+                return makeLeaf();
+            }
+
+            // a leaf costs one intersection per batch, a split costs one per primitive in each child, spread over batches
+            value_type leaf_cost = static_cast<value_type>((count + m_batch_width - 1) / m_batch_width);
+            value_type split_cost = traversal_cost + best_cost / bounds.getSurfaceArea() / static_cast<value_type>(m_batch_width);
+            if(count <= max_leaf_size * m_batch_width && leaf_cost <= split_cost) {
+                return makeLeaf();
+            }
+
+            value_type scale = static_cast<value_type>(number_of_bins) / centroid_extent[best_axis];
+            value_type axis_min = centroid_bounds.getMin()[best_axis];
+            auto middle = std::partition(entries.begin() + static_cast<std::ptrdiff_t>(begin),
+                                         entries.begin() + static_cast<std::ptrdiff_t>(end),
+                                         [&](const BuildEntry& entry) {
+                                             return getBin(entry.centroid[best_axis], axis_min, scale) < best_split;
+                                         });
+            auto middle_index = static_cast<size_t>(std::distance(entries.begin(), middle));
+
+            buildRecursive(entries, begin, middle_index, depth + 1);
+            m_nodes[node_index].offset = buildRecursive(entries, middle_index, end, depth + 1);
+            return node_index;
+        }
+
+        [[nodiscard]] static size_t getBin(value_type value, value_type axis_min, value_type scale)
+        {
+            auto bin = static_cast<size_t>((value - axis_min) * scale);
+            return std::min(bin, number_of_bins - 1);
+        }
+
+    public:
+        BoundingVolumeHierarchy() = default;
+        ~BoundingVolumeHierarchy() = default;
+        BoundingVolumeHierarchy(const BoundingVolumeHierarchy& other) = default;
+        BoundingVolumeHierarchy(BoundingVolumeHierarchy&& other) noexcept = default;
+        BoundingVolumeHierarchy& operator=(const BoundingVolumeHierarchy& other) = default;
+        BoundingVolumeHierarchy& operator=(BoundingVolumeHierarchy&& other) noexcept = default;
+
+        /*!
+         * Build the hierarchy over the elements of the bounded geometry in \p geometry, replacing anything built
+         * previously. Unbounded geometry is skipped and must be tested separately.
+         * @param geometry the geometry to place in the hierarchy
+         * @param batch_width how many primitives of a leaf are intersected at once, i.e. by a SIMD kernel. Wider
+         *                    batches make bigger leaves cheaper, so the hierarchy gets shallower
+         */
+        void build(const std::vector<Geometry_Ptr>& geometry, size_t batch_width = 1)
+        {
+            m_batch_width = std::max<size_t>(batch_width, 1);
+            m_nodes.clear();
+            m_primitives.clear();
+
+            std::vector<BuildEntry> entries;
+            entries.reserve(geometry.size());
+            for(size_t i = 0; i < geometry.size(); i++) {
+                if(!geometry[i]->isBounded()) {
+                    continue;
+                }
+                uint32_t element_count = geometry[i]->getElementCount();
+                for(uint32_t element = 0; element < element_count; element++) {
+                    std::optional<BoundingBox_3> bounds = geometry[i]->getElementBoundingBox(element);
+                    if(bounds.has_value()) {
+                        entries.push_back({bounds.value(), geometry[i]->getElementCentroid(element),
+                                           {static_cast<uint32_t>(i), element}});
+                    }
+                }
+            }
+            if(entries.empty()) {
+                return;
+            }
+
+            m_nodes.reserve(2 * entries.size());
+            m_primitives.reserve(entries.size());
+            buildRecursive(entries, 0, entries.size(), 0);
+        }
+
+        /*!
+         * Reorder the primitives within each leaf, leaving the nodes as they are. The sort is stable, so sorting again
+         * with the same \p key changes nothing.
+         * @param key called with an ElementReference, gives a value the primitives of each leaf are sorted by
+         */
+        template<typename Key>
+        void sortLeaves(Key&& key)
+        {
+            for(const Node& node : m_nodes) {
+                if(node.count > 1) {
+                    auto begin = m_primitives.begin() + node.offset;
+                    std::stable_sort(begin, begin + node.count, [&](const ElementReference& lhs, const ElementReference& rhs) {
+                        return key(lhs) < key(rhs);
+                    });
+                }
+            }
+        }
+
+        /*!
+         * Write the hierarchy in binary form, as used by the scene cache
+         */
+        void writeBinary(utility::BinaryWriter& writer) const
+        {
+            writer.write<uint64_t>(m_batch_width);
+            writer.write<uint64_t>(m_nodes.size());
+            for(const Node& node : m_nodes) {
+                writer.write(node.bounds.getMin());
+                writer.write(node.bounds.getMax());
+                writer.write(node.offset);
+                writer.write(node.count);
+            }
+            writer.writeVector<ElementReference>(m_primitives);
+        }
+
+        /*!
+         * Replace the hierarchy with one written by writeBinary
+         * @throws std::runtime_error if the data is malformed
+         */
+        void readBinary(utility::BinaryReader& reader)
+        {
+            m_batch_width = reader.read<uint64_t>();
+            auto node_count = reader.read<uint64_t>();
+            m_nodes.clear();
+            for(uint64_t i = 0; i < node_count; i++) {
+                Node node;
+                auto min = reader.read<Point_3>();
+                auto max = reader.read<Point_3>();
+                // an empty box has its corners inverted, which the corner constructor would reorder
+                bool is_empty = false;
+                for(size_t axis = 0; axis < 3; axis++) {
+                    is_empty = is_empty || min[axis] > max[axis];
+                }
+                if(!is_empty) {
+                    node.bounds = BoundingBox_3(min, max);
+                }
+                node.offset = reader.read<uint32_t>();
+                node.count = reader.read<uint32_t>();
+                m_nodes.push_back(node);
+            }
+            m_primitives = reader.readVector<ElementReference>();
+            // children always come after their parent, so every node's depth is known before it is reached. Deeper
+            // nodes than the build makes would overflow the traversal stack
+            std::vector<size_t> depths(m_nodes.size(), 0);
+            for(size_t i = 0; i < m_nodes.size(); i++) {
+                const Node& node = m_nodes[i];
+                bool is_valid = node.count > 0 ? static_cast<size_t>(node.offset) + node.count <= m_primitives.size()
+                                               : node.offset > i + 1 && node.offset < m_nodes.size();
+                if(!is_valid || depths[i] > max_depth) {
+                    throw std::runtime_error("malformed bounding volume hierarchy in binary data");
+                }
+                if(node.count == 0) {
+                    depths[i + 1] = std::max(depths[i + 1], depths[i] + 1);
+                    depths[node.offset] = std::max(depths[node.offset], depths[i] + 1);
+                }
+            }
+        }
+
+        /*!
+         * @return how many primitives of a leaf the hierarchy was built to intersect at once
+         */
+        [[nodiscard]] size_t getBatchWidth() const { return m_batch_width; }
+
+        /*!
+         * @return true if nothing has been placed in the hierarchy
+         */
+        [[nodiscard]] bool empty() const { return m_nodes.empty(); }
+
+        /*!
+         * @return the number of nodes in the hierarchy
+         */
+        [[nodiscard]] size_t getNodeCount() const { return m_nodes.size(); }
+
+        /*!
+         * @return the element in each primitive slot. The primitives of each leaf occupy consecutive slots
+         */
+        [[nodiscard]] const std::vector<ElementReference>& getPrimitives() const { return m_primitives; }
+
+        /*!
+         * Slab test of \p bounds against the rays of \p packet in \p rays, a simd::Pack of rays at a time. Per ray, gives
+         * the same answer as BoundingBox::getEntryDistance with a t_min of 0.
+         * @param nearest_entry set to the smallest entry distance of the rays that enter the box
+         * @return a mask of the rays in \p rays that enter the box before their \p t_max
+         */
+        [[nodiscard]] static uint32_t getEnteringRays(const BoundingBox_3& bounds, const RayPacket<value_type>& packet,
+                                                      const typename RayPacket<value_type>::Lanes& t_max, uint32_t rays,
+                                                      value_type& nearest_entry)
+        {
+            using Pack = simd::Pack<value_type>;
+            uint32_t entering = 0;
+            nearest_entry = std::numeric_limits<value_type>::max();
+            for(size_t lane = 0; lane < RayPacket<value_type>::size; lane += Pack::width) {
+                if(((rays >> lane) & ((1u << Pack::width) - 1)) == 0) {
+                    continue;
+                }
+                Pack t_enter = Pack::broadcast(0);
+                Pack t_exit = Pack::load(&t_max[lane]);
+                for(size_t axis = 0; axis < 3; axis++) {
+                    Pack origin = Pack::load(&packet.origin[axis][lane]);
+                    Pack inverse_direction = Pack::load(&packet.inverse_direction[axis][lane]);
+                    Pack t_near = (Pack::broadcast(bounds.getMin()[axis]) - origin) * inverse_direction;
+                    Pack t_far = (Pack::broadcast(bounds.getMax()[axis]) - origin) * inverse_direction;
+                    auto swapped = t_near > t_far;
+                    Pack t_low = Pack::select(swapped, t_far, t_near);
+                    Pack t_high = Pack::select(swapped, t_near, t_far);
+                    // written so that a NaN leaves the interval unchanged, as in the scalar test
+                    t_enter = Pack::select(t_low > t_enter, t_low, t_enter);
+                    t_exit = Pack::select(t_high < t_exit, t_high, t_exit);
+                }
+                uint32_t hits = ((t_enter <= t_exit).bits() << lane) & rays;
+                if(hits == 0) {
+                    continue;
+                }
+                entering |= hits;
+                std::array<value_type, Pack::width> entries;
+                t_enter.store(entries.data());
+                for(size_t i = 0; i < Pack::width; i++) {
+                    if((hits >> (lane + i)) & 1) {
+                        nearest_entry = std::min(nearest_entry, entries[i]);
+                    }
+                }
+            }
+            return entering;
+        }
+
+        /*!
+         * Visit every primitive in a leaf whose bounds the \p ray enters before \p t_max. Children are visited nearest
+         * first, and \p t_max is re-read after each primitive, so shrinking it from \p visit prunes the rest of the
+         * traversal.
+         * @param ray the ray to traverse the hierarchy with
+         * @param t_max the furthest ray parameter of interest
+         * @param visit called with the ElementReference of each candidate primitive
+         */
+        template<typename Visitor>
+        void traverse(const Ray_3& ray, const value_type& t_max, Visitor&& visit) const
+        {
+            traverseLeaves(ray, t_max, [&](uint32_t first, uint32_t count) {
+                for(uint32_t slot = first; slot < first + count; slot++) {
+                    visit(m_primitives[slot]);
+                }
+            });
+        }
+
+        /*!
+         * Visit every leaf whose bounds the \p ray enters before \p t_max, nearest first. \p t_max is re-read after each
+         * leaf, so shrinking it from \p visit prunes the rest of the traversal.
+         * @param ray the ray to traverse the hierarchy with
+         * @param t_max the furthest ray parameter of interest
+         * @param visit called with the first primitive slot of the leaf and the number of slots in it
+         */
+        template<typename LeafVisitor>
+        void traverseLeaves(const Ray_3& ray, const value_type& t_max, LeafVisitor&& visit) const
+        {
+            traverseLeavesUntil(ray, t_max, [&](uint32_t first, uint32_t count) {
+                visit(first, count);
+                return false;
+            });
+        }
+
+        /*!
+         * Like traverseLeaves, but stops as soon as \p visit returns true, e.g. for any hit queries
+         * @param ray the ray to traverse the hierarchy with
+         * @param t_max the furthest ray parameter of interest
+         * @param visit called with the first primitive slot of the leaf and the number of slots in it
+         * @return true if \p visit stopped the traversal
+         */
+        template<typename LeafVisitor>
+        bool traverseLeavesUntil(const Ray_3& ray, const value_type& t_max, LeafVisitor&& visit) const
+        {
+            if(m_nodes.empty()) {
+                return false;
+            }
+
+            const Point_3 origin = ray.getOrigin();
+            const Vector_3 inverse_direction = ray.getInverse();
+
+            struct StackEntry
+            {
+                uint32_t node;
+                value_type t_entry;
+            };
+            std::array<StackEntry, max_depth + 1> stack;
+            size_t stack_size = 0;
+
+            std::optional<value_type> root_entry = m_nodes[0].bounds.getEntryDistance(origin, inverse_direction, 0, t_max);
+            if(!root_entry.has_value()) {
+                return false;
+            }
+            stack[stack_size++] = {0, root_entry.value()};
+
+            while(stack_size > 0) {
+                StackEntry current = stack[--stack_size];
+                if(current.t_entry > t_max) {
+                    continue;
+                }
+
+                const Node& node = m_nodes[current.node];
+                if(node.count > 0) {
+                    if(visit(node.offset, node.count)) {
+                        return true;
+                    }
+                    continue;
+                }
+
+                uint32_t near_child = current.node + 1;
+                uint32_t far_child = node.offset;
+                std::optional<value_type> near_entry = m_nodes[near_child].bounds.getEntryDistance(origin, inverse_direction, 0, t_max);
+                std::optional<value_type> far_entry = m_nodes[far_child].bounds.getEntryDistance(origin, inverse_direction, 0, t_max);
+                if(near_entry.has_value() && far_entry.has_value() && far_entry.value() < near_entry.value()) {
+                    std::swap(near_child, far_child);
+                    std::swap(near_entry, far_entry);
+                }
+                // push the far child first so the near child is popped first
+                if(far_entry.has_value()) {
+                    stack[stack_size++] = {far_child, far_entry.value()};
+                }
+                if(near_entry.has_value()) {
+                    stack[stack_size++] = {near_child, near_entry.value()};
+                }
+            }
+            return false;
+        }
+
+        /*!
+         * Packet version of traverseLeaves, for coherent rays such as those of neighbouring pixels. Nodes are tested
+         * against all the rays of the \p packet together, and visited nearest first (by the nearest ray) if any of them
+         * enters the node before its own \p t_max. \p t_max is re-read after each leaf.
+         * @param packet the rays to traverse the hierarchy with
+         * @param t_max the furthest ray parameter of interest for each ray of \p packet
+         * @param visit called with the first primitive slot of the leaf, the number of slots in it, and a mask of the rays
+         * that enter the leaf's bounds
+         */
+        template<typename LeafVisitor>
+        void traversePacketLeaves(const RayPacket<value_type>& packet, const typename RayPacket<value_type>::Lanes& t_max,
+                                  LeafVisitor&& visit) const
+        {
+            if(m_nodes.empty()) {
+                return;
+            }
+
+            struct StackEntry
+            {
+                uint32_t node;
+                uint32_t rays;
+                value_type t_entry;
+            };
+            std::array<StackEntry, max_depth + 1> stack;
+            size_t stack_size = 0;
+
+            value_type root_entry;
+            uint32_t root_rays = getEnteringRays(m_nodes[0].bounds, packet, t_max, packet.getActiveRays(), root_entry);
+            if(root_rays == 0) {
+                return;
+            }
+            stack[stack_size++] = {0, root_rays, root_entry};
+
+            while(stack_size > 0) {
+                StackEntry current = stack[--stack_size];
+                // t_entry is the nearest entry of all the rays, so rays that have since found a closer hit can be dropped
+                for(uint32_t remaining = current.rays; remaining != 0; remaining &= remaining - 1) {
+                    int lane = std::countr_zero(remaining);
+                    if(current.t_entry > t_max[lane]) {
+                        current.rays &= ~(1u << lane);
+                    }
+                }
+                if(current.rays == 0) {
+                    continue;
+                }
+
+                const Node& node = m_nodes[current.node];
+                if(node.count > 0) {
+                    visit(node.offset, node.count, current.rays);
+                    continue;
+                }
+
+                uint32_t near_child = current.node + 1;
+                uint32_t far_child = node.offset;
+                value_type near_entry, far_entry;
+                uint32_t near_rays = getEnteringRays(m_nodes[near_child].bounds, packet, t_max, current.rays, near_entry);
+                uint32_t far_rays = getEnteringRays(m_nodes[far_child].bounds, packet, t_max, current.rays, far_entry);
+                if(near_rays != 0 && far_rays != 0 && far_entry < near_entry) {
+                    std::swap(near_child, far_child);
+                    std::swap(near_rays, far_rays);
+                    std::swap(near_entry, far_entry);
+                }
+                // push the far child first so the near child is popped first
+                if(far_rays != 0) {
+                    stack[stack_size++] = {far_child, far_rays, far_entry};
+                }
+                if(near_rays != 0) {
+                    stack[stack_size++] = {near_child, near_rays, near_entry};
+                }
+            }
+        }
+    };
+}
@@ -4,11 +4,21 @@
 
 #pragma once
 
+#include <typeinfo>
+#include <utility>
+
 #include "LinearAlgebraTypeTraits.h"
 #include "Ray.h"
 #include "Geometry.h"
 #include "Color.h"
 #include "GeometryBuilder.h"
+#include "TriangleMesh.h"
+#include "BoundingVolumeHierarchy.h"
+#include "PrimitiveStore.h"
+#include "SphereBatch.h"
+#include "TriangleBatch.h"
+#include "BinaryStream.h"
+#include "RayPacket.h"
 #include "json.h"
 
 namespace environment
@@ -25,15 +35,255 @@ namespace environment
     {
     public:
         using Geometry_Ptr = std::shared_ptr<Geometry<value_type>>;
-        // TODO: use something smarter than just a vector to store these
         using GeometryContainer = std::vector<Geometry_Ptr>;
         using Ray_3 = Ray<3, value_type>;
         using Point_3 = Point_X<3, value_type>;
+        using Hit_Record = HitRecord<value_type>;
 
     private:
         GeometryContainer m_geometry;
+        // bounded geometry lives in the hierarchy, anything without a bounding box (i.e. planes) is always tested
+        BoundingVolumeHierarchy<value_type> m_hierarchy;
+        std::vector<ElementReference> m_unbounded_geometry;
+        // used for intersection queries in GeometryStorage::Packed mode. Once it is built, the built in geometry in
+        // m_geometry points into it, so there is only one copy
+        PrimitiveStore<value_type> m_primitives;
+        // in packed mode, the spheres and standalone triangles of the hierarchy, in slot order
+        SphereBatch<value_type> m_leaf_spheres;
+        TriangleBatch<value_type> m_leaf_triangles;
+        // the meshes in the hierarchy, which are intersected straight from their vertex buffers
+        std::vector<const TriangleMesh<value_type>*> m_leaf_meshes;
+        // the SlotKind of each slot of the hierarchy
+        std::vector<uint8_t> m_slot_kinds;
+        // for each slot of the hierarchy, its index in m_leaf_spheres, m_leaf_triangles or m_leaf_meshes, depending on
+        // its kind
+        std::vector<uint32_t> m_slot_indices;
+        GeometryStorage m_geometry_storage = GeometryStorage::Packed;
+        // set when geometry is added after the last call to buildAccelerationStructure
+        bool m_acceleration_structure_is_stale = false;
         Color m_backgroundColor{};
 
+        /*!
+         * Calls \p visit with the ElementReference of every element of the geometry that the \p ray could hit before
+         * \p t_max
+         */
+        template<typename Visitor>
+        void forEachCandidate(const Ray_3& ray, const value_type& t_max, Visitor&& visit) const
+        {
+            if(m_acceleration_structure_is_stale) {
+                for(uint32_t i = 0; i < m_geometry.size(); i++) {
+                    uint32_t element_count = m_geometry[i]->getElementCount();
+                    for(uint32_t element = 0; element < element_count; element++) {
+                        visit(ElementReference{i, element});
+                    }
+                }
+                return;
+            }
+            for(const ElementReference& element : m_unbounded_geometry) {
+                visit(element);
+            }
+            m_hierarchy.traverse(ray, t_max, visit);
+        }
+
+        /*!
+         * @return true if queries should go through the packed copies of the geometry
+         */
+        [[nodiscard]] bool usePackedGeometry() const
+        {
+            return m_geometry_storage == GeometryStorage::Packed && !m_acceleration_structure_is_stale;
+        }
+
+        /*!
+         * The slots of each leaf are sorted by kind, so the primitives of each kind form one run of consecutive slots
+         */
+        enum SlotKind : uint8_t
+        {
+            SphereSlot,
+            TriangleSlot,
+            MeshSlot,
+            OtherSlot
+        };
+
+        [[nodiscard]] SlotKind getSlotKind(uint32_t geometry) const
+        {
+            const Geometry<value_type>& item = *m_geometry[geometry];
+            if(typeid(item) == typeid(Sphere<value_type>)) {
+                return SphereSlot;
+            } else if(typeid(item) == typeid(Triangle<value_type>)) {
+                return TriangleSlot;
+            } else if(dynamic_cast<const TriangleMesh<value_type>*>(&item) != nullptr) {
+                return MeshSlot;
+            }
+            return OtherSlot;
+        }
+
+        /*!
+         * Lay the spheres and standalone triangles of the hierarchy out for the batch kernels, and find the meshes,
+         * leaving everything else to the primitive store. Mesh triangles stay in their mesh's index buffer.
+         */
+        void buildLeafBatches()
+        {
+            m_leaf_spheres = SphereBatch<value_type>();
+            m_leaf_triangles = TriangleBatch<value_type>();
+            m_leaf_meshes.clear();
+            m_slot_kinds.clear();
+            m_slot_indices.clear();
+            // index of each mesh in m_leaf_meshes, by geometry id
+            std::vector<uint32_t> mesh_indices(m_geometry.size(), Hit_Record::invalid_id);
+            for(const ElementReference& slot : m_hierarchy.getPrimitives()) {
+                SlotKind kind = getSlotKind(slot.geometry);
+                uint32_t index = 0;
+                if(kind == SphereSlot) {
+                    index = static_cast<uint32_t>(m_leaf_spheres.size());
+                    m_leaf_spheres.add(*m_primitives.template getAs<Sphere<value_type>>(slot.geometry), slot.geometry);
+                } else if(kind == TriangleSlot) {
+                    index = static_cast<uint32_t>(m_leaf_triangles.size());
+                    m_leaf_triangles.add(*m_primitives.template getAs<Triangle<value_type>>(slot.geometry), slot.geometry);
+                } else if(kind == MeshSlot) {
+                    if(mesh_indices[slot.geometry] == Hit_Record::invalid_id) {
+                        mesh_indices[slot.geometry] = static_cast<uint32_t>(m_leaf_meshes.size());
+                        m_leaf_meshes.push_back(m_primitives.template getAs<TriangleMesh<value_type>>(slot.geometry));
+                    }
+                    index = mesh_indices[slot.geometry];
+                }
+                m_slot_kinds.push_back(kind);
+                m_slot_indices.push_back(index);
+            }
+        }
+
+        /*!
+         * Set up everything that is derived from the geometry and the hierarchy, once the hierarchy is in place
+         */
+        void finishAccelerationStructure()
+        {
+            m_unbounded_geometry.clear();
+            for(uint32_t i = 0; i < m_geometry.size(); i++) {
+                if(!m_geometry[i]->isBounded()) {
+                    uint32_t element_count = m_geometry[i]->getElementCount();
+                    for(uint32_t element = 0; element < element_count; element++) {
+                        m_unbounded_geometry.push_back({i, element});
+                    }
+                }
+            }
+            // sorted in both storage modes, so both test the primitives of a leaf in the same order
+            m_hierarchy.sortLeaves([this](const ElementReference& slot) { return std::pair(getSlotKind(slot.geometry), slot.geometry); });
+            if(m_geometry_storage == GeometryStorage::Packed) {
+                m_primitives.build(m_geometry);
+                for(uint32_t i = 0; i < m_geometry.size(); i++) {
+                    m_geometry[i] = m_primitives.share(i);
+                }
+                buildLeafBatches();
+            } else {
+                m_primitives = PrimitiveStore<value_type>();
+                m_leaf_spheres = SphereBatch<value_type>();
+                m_leaf_triangles = TriangleBatch<value_type>();
+                m_leaf_meshes.clear();
+                m_slot_kinds.clear();
+                m_slot_indices.clear();
+            }
+            m_acceleration_structure_is_stale = false;
+        }
+
+        /*!
+         * Call \p visit with the kind, first slot and number of slots of each run of slots of the same kind in the
+         * \p count slots of a leaf starting at \p first, until \p visit returns true. Runs of mesh slots are split by
+         * mesh.
+         * @return true if \p visit returned true
+         */
+        template<typename RunVisitor>
+        bool forEachRun(uint32_t first, uint32_t count, RunVisitor&& visit) const
+        {
+            uint32_t end = first + count;
+            for(uint32_t run_first = first; run_first < end;) {
+                uint32_t run_end = run_first + 1;
+                while(run_end < end && m_slot_kinds[run_end] == m_slot_kinds[run_first] &&
+                      (m_slot_kinds[run_first] != MeshSlot || m_slot_indices[run_end] == m_slot_indices[run_first])) {
+                    run_end++;
+                }
+                if(visit(static_cast<SlotKind>(m_slot_kinds[run_first]), run_first, run_end - run_first)) {
+                    return true;
+                }
+                run_first = run_end;
+            }
+            return false;
+        }
+
+        /*!
+         * @return the batch width the hierarchy should be built with for the current geometry storage
+         */
+        [[nodiscard]] size_t getHierarchyBatchWidth() const
+        {
+            // the packed leaves are intersected a whole simd::Pack at a time
+            return m_geometry_storage == GeometryStorage::Packed ? simd::Pack<value_type>::width : 1;
+        }
+
+        /*!
+         * Intersect the \p ray with the \p count primitives of a hierarchy leaf starting at slot \p first
+         */
+        void intersectLeaf(uint32_t first, uint32_t count, const Ray_3& ray, Hit_Record& record) const
+        {
+            const std::vector<ElementReference>& primitives = m_hierarchy.getPrimitives();
+            forEachRun(first, count, [&](SlotKind kind, uint32_t run_first, uint32_t run_count) {
+                if(kind == SphereSlot) {
+                    m_leaf_spheres.intersect(m_slot_indices[run_first], run_count, ray, record);
+                } else if(kind == TriangleSlot) {
+                    m_leaf_triangles.intersect(m_slot_indices[run_first], run_count, ray, record);
+                } else if(kind == MeshSlot) {
+                    m_leaf_meshes[m_slot_indices[run_first]]->intersectElements(&primitives[run_first], run_count, ray, record);
+                } else {
+                    for(uint32_t slot = run_first; slot < run_first + run_count; slot++) {
+                        if(m_primitives.intersect(primitives[slot], ray, record)) {
+                            record.primitive_id = primitives[slot].geometry;
+                            record.element_id = primitives[slot].element;
+                        }
+                    }
+                }
+                return false;
+            });
+        }
+
+        /*!
+         * Fill in the rest of the \p record of the closest hit along the \p ray once the search is over
+         * @return the completed record, or std::nullopt if nothing was hit
+         */
+        [[nodiscard]] std::optional<Hit_Record> completeClosestHit(const Ray_3& ray, Hit_Record& record) const
+        {
+            if(!record.hasHit()) {
+                return std::nullopt;
+            }
+            if(usePackedGeometry()) {
+                record.geometry = m_primitives.get(record.primitive_id);
+                m_primitives.completeHitRecord(record.primitive_id, ray, record);
+            } else {
+                record.geometry = m_geometry[record.primitive_id].get();
+                record.geometry->completeHitRecord(ray, record);
+            }
+            return record;
+        }
+
+        /*!
+         * Any hit version of intersectLeaf
+         */
+        [[nodiscard]] bool occludedByLeaf(uint32_t first, uint32_t count, const Ray_3& ray, value_type t_max) const
+        {
+            const std::vector<ElementReference>& primitives = m_hierarchy.getPrimitives();
+            return forEachRun(first, count, [&](SlotKind kind, uint32_t run_first, uint32_t run_count) {
+                if(kind == SphereSlot) {
+                    return m_leaf_spheres.occluded(m_slot_indices[run_first], run_count, ray, t_max);
+                } else if(kind == TriangleSlot) {
+                    return m_leaf_triangles.occluded(m_slot_indices[run_first], run_count, ray, t_max);
+                } else if(kind == MeshSlot) {
+                    return m_leaf_meshes[m_slot_indices[run_first]]->occludesElements(&primitives[run_first], run_count, ray, t_max);
+                }
+                for(uint32_t slot = run_first; slot < run_first + run_count; slot++) {
+                    if(m_primitives.occludes(primitives[slot], ray, t_max)) {
+                        return true;
+                    }
+                }
+                return false;
+            });
+        }
+
     public:
         Environment() = default;
         ~Environment() = default;
@@ -58,7 +308,11 @@ namespace environment
         /*!
          * @param new_geometry geometry to add
          */
-        void addGeometry(const Geometry_Ptr& new_geometry) { m_geometry.push_back(new_geometry); }
+        void addGeometry(const Geometry_Ptr& new_geometry)
+        {
+            m_geometry.push_back(new_geometry);
+            m_acceleration_structure_is_stale = true;
+        }
 
         /*!
          * @param geometry_list list of geometry to add
@@ -69,6 +323,7 @@ namespace environment
             {
                 m_geometry.push_back(geometry);
             }
+            m_acceleration_structure_is_stale = true;
         }
 
         /*!
@@ -77,6 +332,7 @@ namespace environment
         void addGeometry(const nlohmann::json& json_object)
         {
             m_geometry.push_back(geometry::GeometryBuilder<value_type>::FromJson(json_object));
+            m_acceleration_structure_is_stale = true;
         }
 
         /*!
@@ -87,6 +343,154 @@ namespace environment
             for(const auto& json_object : json_list) {
                 m_geometry.push_back(geometry::GeometryBuilder<value_type>::FromJson(json_object));
             }
+            m_acceleration_structure_is_stale = true;
+        }
+
+        /*!
+         * Choose how geometry is stored for intersection queries. Takes effect at the next buildAccelerationStructure
+         * @param storage the storage mode
+         */
+        void setGeometryStorage(GeometryStorage storage)
+        {
+            m_geometry_storage = storage;
+            m_acceleration_structure_is_stale = true;
+        }
+
+        [[nodiscard]] GeometryStorage getGeometryStorage() const { return m_geometry_storage; }
+
+        /*!
+         * Rebuild the bounding volume hierarchy over all the current geometry, and the packed copies of the geometry if
+         * they are in use. Until this is called, any geometry added to the environment makes the intersection queries
+         * fall back to testing every object through the Geometry interface.
+         *
+         * In packed mode, the built in geometry is copied into the primitive store and getGeometry returns pointers to
+         * those copies, releasing the environment's references to the geometry as it was added.
+         */
+        void buildAccelerationStructure()
+        {
+            m_hierarchy.build(m_geometry, getHierarchyBatchWidth());
+            finishAccelerationStructure();
+        }
+
+        /*!
+         * Finds the closest intersection along the \p ray, ignoring anything at or beyond \p t_max. Each candidate is
+         * intersected once, and the search narrows as closer hits are found.
+         * @param ray Ray to check for intersection
+         * @param t_max the furthest ray parameter to consider
+         * @return the completed record of the closest hit, or std::nullopt if nothing was hit
+         */
+        [[nodiscard]] std::optional<Hit_Record> getClosestHit(const Ray_3& ray,
+                                                              value_type t_max = std::numeric_limits<value_type>::max()) const
+        {
+            Hit_Record record;
+            record.t = t_max;
+            if(usePackedGeometry()) {
+                for(const ElementReference& element : m_unbounded_geometry) {
+                    if(m_primitives.intersect(element, ray, record)) {
+                        record.primitive_id = element.geometry;
+                        record.element_id = element.element;
+                    }
+                }
+                m_hierarchy.traverseLeaves(ray, record.t, [&](uint32_t first, uint32_t count) {
+                    intersectLeaf(first, count, ray, record);
+                });
+            } else {
+                forEachCandidate(ray, record.t, [&](const ElementReference& element) {
+                    if(m_geometry[element.geometry]->intersectElement(element.element, ray, record)) {
+                        record.primitive_id = element.geometry;
+                        record.element_id = element.element;
+                    }
+                });
+            }
+            return completeClosestHit(ray, record);
+        }
+
+        /*!
+         * Packet version of getClosestHit, for coherent rays such as those of neighbouring pixels. The bounding volume
+         * hierarchy is traversed once for the whole \p packet, and each leaf is only intersected with the rays that enter
+         * it. Gives the same hits as calling getClosestHit for each ray.
+         * @param packet the rays to check for intersection
+         * @param hits set to the completed record of the closest hit of each ray in use, or std::nullopt if it hit nothing
+         */
+        void getClosestHits(const RayPacket<value_type>& packet,
+                            std::array<std::optional<Hit_Record>, RayPacket<value_type>::size>& hits) const
+        {
+            std::array<Ray_3, RayPacket<value_type>::size> rays;
+            for(size_t lane = 0; lane < packet.count; lane++) {
+                rays[lane] = packet.getRay(lane);
+            }
+            if(!usePackedGeometry()) {
+                for(size_t lane = 0; lane < packet.count; lane++) {
+                    hits[lane] = getClosestHit(rays[lane]);
+                }
+                return;
+            }
+
+            std::array<Hit_Record, RayPacket<value_type>::size> records;
+            typename RayPacket<value_type>::Lanes t_max;
+            for(size_t lane = 0; lane < packet.count; lane++) {
+                for(const ElementReference& element : m_unbounded_geometry) {
+                    if(m_primitives.intersect(element, rays[lane], records[lane])) {
+                        records[lane].primitive_id = element.geometry;
+                        records[lane].element_id = element.element;
+                    }
+                }
+                t_max[lane] = records[lane].t;
+            }
+            m_hierarchy.traversePacketLeaves(packet, t_max, [&](uint32_t first, uint32_t count, uint32_t packet_rays) {
+                for(size_t lane = 0; lane < packet.count; lane++) {
+                    if((packet_rays >> lane) & 1) {
+                        intersectLeaf(first, count, rays[lane], records[lane]);
+                        t_max[lane] = records[lane].t;
+                    }
+                }
+            });
+            for(size_t lane = 0; lane < packet.count; lane++) {
+                hits[lane] = completeClosestHit(rays[lane], records[lane]);
+            }
+        }
+
+        /*!
+         * Any hit query for shadow and visibility rays. Stops at the first hit found, whichever it is, and never
+         * allocates.
+         * @param ray Ray to check for intersection
+         * @param t_max the furthest ray parameter to consider, i.e. the distance to a light along a normalized ray
+         * @return true if anything is hit along the \p ray in [0, \p t_max)
+         */
+        [[nodiscard]] bool occluded(const Ray_3& ray, value_type t_max = std::numeric_limits<value_type>::max()) const
+        {
+            if(m_acceleration_structure_is_stale) {
+                for(const Geometry_Ptr& geometry : m_geometry) {
+                    if(geometry->occludes(ray, t_max)) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+            if(usePackedGeometry()) {
+                for(const ElementReference& element : m_unbounded_geometry) {
+                    if(m_primitives.occludes(element, ray, t_max)) {
+                        return true;
+                    }
+                }
+                return m_hierarchy.traverseLeavesUntil(ray, t_max, [&](uint32_t first, uint32_t count) {
+                    return occludedByLeaf(first, count, ray, t_max);
+                });
+            }
+            for(const ElementReference& element : m_unbounded_geometry) {
+                if(m_geometry[element.geometry]->occludesElement(element.element, ray, t_max)) {
+                    return true;
+                }
+            }
+            const std::vector<ElementReference>& primitives = m_hierarchy.getPrimitives();
+            return m_hierarchy.traverseLeavesUntil(ray, t_max, [&](uint32_t first, uint32_t count) {
+                for(uint32_t slot = first; slot < first + count; slot++) {
+                    if(m_geometry[primitives[slot].geometry]->occludesElement(primitives[slot].element, ray, t_max)) {
+                        return true;
+                    }
+                }
+                return false;
+            });
         }
 
         /*!
@@ -97,20 +501,11 @@ namespace environment
          */
         [[nodiscard]] Geometry_Ptr getFirstIntersectedGeometry(const Ray_3& ray) const
         {
-            Geometry_Ptr geometry_to_return = nullptr;
-            value_type current_shortest_distance = std::numeric_limits<value_type>::max();
-            for(const auto& geometry : m_geometry) {
-                std::optional<Point_3> intersection_point = geometry->getIntersectionPoint(ray);
-                if(intersection_point.has_value()) {
-                    value_type distance_to_object = (intersection_point.value() - ray.getOrigin()).getMagnitude();
-                    if(distance_to_object < current_shortest_distance)
-                    {
-                        geometry_to_return = geometry;
-                        current_shortest_distance = distance_to_object;
-                    }
-                }
+            std::optional<Hit_Record> hit = getClosestHit(ray);
+            if(!hit.has_value()) {
+                return nullptr;
             }
-            return geometry_to_return;
+            return m_geometry[hit->primitive_id];
         }
 
         /*!
@@ -121,14 +516,24 @@ namespace environment
         [[nodiscard]] std::vector<Geometry_Ptr> getIntersectingGeometry(const Ray_3& ray) const
         {
             std::vector<Geometry_Ptr> result;
-            for(const auto& geometry_object : m_geometry) {
-                if(geometry_object->intersects(ray)) {
-                    result.push_back(geometry_object);
+            // geometry made of several elements is only reported once
+            std::vector<bool> is_reported(m_geometry.size(), false);
+            const value_type t_max = std::numeric_limits<value_type>::max();
+            forEachCandidate(ray, t_max, [&](const ElementReference& element) {
+                Hit_Record record;
+                if(!is_reported[element.geometry] && m_geometry[element.geometry]->intersectElement(element.element, ray, record)) {
+                    is_reported[element.geometry] = true;
+                    result.push_back(m_geometry[element.geometry]);
                 }
-            }
+            });
             return result;
         }
 
+        /*!
+         * @param background_color the color blended with white to make the background
+         */
+        void setBackgroundColor(const Color& background_color) { m_backgroundColor = background_color; }
+
         /*!
          * Returns the background color, blended with white based on the y value of the given \p ray.
          * @param ray Ray to get the background color for
@@ -137,11 +542,63 @@ namespace environment
         [[nodiscard]] Color getBackgroundColor(const Ray_3& ray) const
         {
             // this should make a gradient from darker to lighter as it goes up the screen
-            value_type t = (ray.getDirection()[1] + 1.0) / 2.0;
+            value_type t = (ray.getDirection()[1] + static_cast<value_type>(1.0)) / static_cast<value_type>(2.0);
             static Color white(216, 232, 255);
             return Color::blend(m_backgroundColor, white, t);
         }
 
+        /*!
+         * Write the environment, including its bounding volume hierarchy, in binary form, as used by the scene cache
+         * @param writer where to write the environment
+         * @return false if the environment can't be written, because it contains geometry that isn't one of the built
+         * in types or its acceleration structure is stale. \p writer is left in an unspecified state
+         */
+        [[nodiscard]] bool writeBinary(utility::BinaryWriter& writer) const
+        {
+            if(m_acceleration_structure_is_stale) {
+                return false;
+            }
+            writer.write(m_backgroundColor);
+            writer.write(m_geometry_storage);
+            writer.write<uint64_t>(m_geometry.size());
+            for(const Geometry_Ptr& geometry : m_geometry) {
+                if(!geometry::GeometryBuilder<value_type>::ToBinary(*geometry, writer)) {
+                    return false;
+                }
+            }
+            m_hierarchy.writeBinary(writer);
+            return true;
+        }
+
+        /*!
+         * Replace the contents of the environment with one written by writeBinary. The hierarchy is only rebuilt if it
+         * was built for a different simd::Pack width than this build uses.
+         * @throws std::runtime_error if the data is malformed
+         */
+        void readBinary(utility::BinaryReader& reader)
+        {
+            m_backgroundColor = reader.read<Color>();
+            m_geometry_storage = reader.read<GeometryStorage>();
+            if(m_geometry_storage != GeometryStorage::Packed && m_geometry_storage != GeometryStorage::Virtual) {
+                throw std::runtime_error("unknown geometry storage in binary data");
+            }
+            auto geometry_count = reader.read<uint64_t>();
+            m_geometry.clear();
+            for(uint64_t i = 0; i < geometry_count; i++) {
+                m_geometry.push_back(geometry::GeometryBuilder<value_type>::FromBinary(reader));
+            }
+            m_hierarchy.readBinary(reader);
+            for(const ElementReference& slot : m_hierarchy.getPrimitives()) {
+                if(slot.geometry >= m_geometry.size() || slot.element >= m_geometry[slot.geometry]->getElementCount()) {
+                    throw std::runtime_error("bounding volume hierarchy refers to missing geometry in binary data");
+                }
+            }
+            if(m_hierarchy.getBatchWidth() != getHierarchyBatchWidth()) {
+                m_hierarchy.build(m_geometry, getHierarchyBatchWidth());
+            }
+            finishAccelerationStructure();
+        }
+
         void fromJson(const nlohmann::json& environment_json)
         {
             nlohmann::json geometry_json, background_color_json;
@@ -157,8 +614,12 @@ namespace environment
                 throw std::invalid_argument("could not find the required 'background_color' key.");
             }
 
+            if(environment_json.contains("geometry_storage")) {
+                m_geometry_storage = GeometryStorageFromString(environment_json.at("geometry_storage").get<std::string>());
+            }
             addGeometryList(geometry_json);
             m_backgroundColor.fromJson(background_color_json);
+            buildAccelerationStructure();
         }
     };
 }
\ No newline at end of file
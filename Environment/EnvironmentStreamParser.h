@@ -0,0 +1,236 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "LinearAlgebraTypeTraits.h"
+#include "Environment.h"
+#include "json.h"
+
+namespace environment
+{
+    /*!
+     * Builds an Environment from its json config with nlohmann::json's SAX interface. Only one entry of the "geometry"
+     * list is held as json at a time: each entry is turned into a Geometry as soon as it is complete and then dropped,
+     * so peak memory follows the size of the geometry rather than the size of a json DOM of the whole config.
+     *
+     * Accepts the same configs as Environment::fromJson, and reports the same errors for missing keys.
+     */
+    template<IsFloatingPoint value_type>
+    class EnvironmentStreamParser : public nlohmann::json_sax<nlohmann::json>
+    {
+    public:
+        /*!
+         * Everything Parse gets out of a config
+         */
+        struct Result
+        {
+            // with its acceleration structure built
+            Environment<value_type> environment;
+            // the files of the meshes in the geometry list, which a cached copy of the environment depends on
+            std::vector<std::string> mesh_files;
+        };
+
+    private:
+        Environment<value_type> m_environment;
+        // every key of the root object other than the geometry list, e.g. the background color
+        nlohmann::json m_settings = nlohmann::json::object();
+        std::vector<std::string> m_mesh_files;
+
+        // nesting depth of the events outside of the value currently being built, 1 inside the root object
+        size_t m_depth = 0;
+        std::string m_root_key;
+        bool m_in_geometry_list = false;
+        bool m_found_geometry_list = false;
+
+        // the value currently being built, and the path to the container that is being filled in
+        nlohmann::json m_value;
+        std::vector<nlohmann::json*> m_containers;
+        std::string m_value_key;
+
+        [[nodiscard]] bool isBuildingValue() const { return !m_containers.empty(); }
+
+        /*!
+         * Called once a complete value has been built, either an entry of the geometry list or a setting
+         */
+        void finishValue()
+        {
+            if(m_in_geometry_list) {
+                if(m_value.is_object() && m_value.contains("file")) {
+                    m_mesh_files.push_back(m_value.at("file").get<std::string>());
+                }
+                m_environment.addGeometry(m_value);
+            } else {
+                m_settings[m_root_key] = std::move(m_value);
+            }
+            m_value = nlohmann::json();
+        }
+
+        /*!
+         * Place \p value in the value being built, or start a new one
+         * @return where \p value ended up
+         */
+        nlohmann::json* place(nlohmann::json&& value)
+        {
+            if(!isBuildingValue()) {
+                if(m_depth == 0) {
+                    throw std::invalid_argument("the environment config must be a json object");
+                }
+                m_value = std::move(value);
+                return &m_value;
+            }
+            nlohmann::json& container = *m_containers.back();
+            if(container.is_array()) {
+                container.push_back(std::move(value));
+                return &container.back();
+            }
+            nlohmann::json& placed = container[m_value_key];
+            placed = std::move(value);
+            return &placed;
+        }
+
+        bool scalar(nlohmann::json&& value)
+        {
+            bool starts_value = !isBuildingValue();
+            place(std::move(value));
+            if(starts_value) {
+                finishValue();
+            }
+            return true;
+        }
+
+        bool startContainer(nlohmann::json&& container)
+        {
+            m_containers.push_back(place(std::move(container)));
+            return true;
+        }
+
+        bool endContainer()
+        {
+            m_containers.pop_back();
+            if(!isBuildingValue()) {
+                finishValue();
+            }
+            return true;
+        }
+
+        /*!
+         * Apply the settings of the config and build the acceleration structure. Call once the whole config has been
+         * parsed
+         * @return the parsed environment
+         * @throws std::invalid_argument if the config is missing required keys
+         */
+        [[nodiscard]] Environment<value_type> takeEnvironment()
+        {
+            if(!m_found_geometry_list) {
+                if(!m_settings.contains("geometry")) {
+                    throw std::invalid_argument("could not find the required 'geometry' key.");
+                }
+                m_environment.addGeometryList(m_settings.at("geometry"));
+            }
+            if(!m_settings.contains("background_color")) {
+                throw std::invalid_argument("could not find the required 'background_color' key.");
+            }
+            if(m_settings.contains("geometry_storage")) {
+                m_environment.setGeometryStorage(GeometryStorageFromString(m_settings.at("geometry_storage").get<std::string>()));
+            }
+            m_environment.setBackgroundColor(Color(m_settings.at("background_color")));
+            m_environment.buildAccelerationStructure();
+            return std::move(m_environment);
+        }
+
+    public:
+        EnvironmentStreamParser() = default;
+        ~EnvironmentStreamParser() override = default;
+        EnvironmentStreamParser(const EnvironmentStreamParser& other) = delete;
+        EnvironmentStreamParser(EnvironmentStreamParser&& other) noexcept = delete;
+        EnvironmentStreamParser& operator=(const EnvironmentStreamParser& other) = delete;
+        EnvironmentStreamParser& operator=(EnvironmentStreamParser&& other) noexcept = delete;
+
+        /*!
+         * Parse an environment config
+         * @param first iterator to the first character of the config
+         * @param last iterator one past the last character of the config
+         * @return the environment and the mesh files it refers to
+         * @throws std::invalid_argument if the config is missing required keys
+         * @throws std::runtime_error if the config isn't valid json
+         */
+        template<typename Iterator>
+        [[nodiscard]] static Result Parse(Iterator first, Iterator last)
+        {
+            EnvironmentStreamParser parser;
+            nlohmann::json::sax_parse(first, last, &parser);
+            Environment<value_type> environment = parser.takeEnvironment();
+            return {std::move(environment), std::move(parser.m_mesh_files)};
+        }
+
+        bool null() override { return scalar(nullptr); }
+        bool boolean(bool value) override { return scalar(value); }
+        bool number_integer(number_integer_t value) override { return scalar(value); }
+        bool number_unsigned(number_unsigned_t value) override { return scalar(value); }
+        bool number_float(number_float_t value, const string_t&) override { return scalar(value); }
+        bool string(string_t& value) override { return scalar(std::move(value)); }
+        bool binary(binary_t& value) override { return scalar(nlohmann::json::binary(std::move(value))); }
+
+        bool start_object(std::size_t) override
+        {
+            if(!isBuildingValue() && m_depth == 0) {
+                m_depth++;
+                return true;
+            }
+            return startContainer(nlohmann::json::object());
+        }
+
+        bool key(string_t& value) override
+        {
+            if(isBuildingValue()) {
+                m_value_key = std::move(value);
+            } else {
+                m_root_key = std::move(value);
+            }
+            return true;
+        }
+
+        bool end_object() override
+        {
+            if(!isBuildingValue()) {
+                m_depth--;
+                return true;
+            }
+            return endContainer();
+        }
+
+        bool start_array(std::size_t) override
+        {
+            if(!isBuildingValue() && !m_in_geometry_list && m_depth == 1 && m_root_key == "geometry") {
+                m_in_geometry_list = true;
+                m_found_geometry_list = true;
+                m_depth++;
+                return true;
+            }
+            return startContainer(nlohmann::json::array());
+        }
+
+        bool end_array() override
+        {
+            if(!isBuildingValue()) {
+                m_in_geometry_list = false;
+                m_depth--;
+                return true;
+            }
+            return endContainer();
+        }
+
+        bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& exception) override
+        {
+            throw std::runtime_error(std::string("could not parse the environment config: ") + exception.what());
+        }
+    };
+}
@@ -0,0 +1,174 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "LinearAlgebraTypeTraits.h"
+#include "Environment.h"
+#include "BinaryStream.h"
+#include "MappedFile.h"
+#include "json.h"
+
+namespace environment
+{
+    /*!
+     * Caches a fully built Environment, geometry and bounding volume hierarchy, in a binary file, so later runs on the
+     * same environment config can skip parsing the config, loading meshes and building the hierarchy. A cache file is
+     * only used if it was written by the same cache version at the same precision, from a config with the same content
+     * hash, and every mesh file the config refers to still has the size and modification time it had when the cache was
+     * written. Anything else, including a damaged cache file, is treated as a miss.
+     */
+    template<IsFloatingPoint value_type>
+    class SceneCache
+    {
+    private:
+        static constexpr uint64_t magic = 0x4548434143535452ull; // "RTSCACHE"
+        // bump whenever the binary layout of anything in the cache changes
+        static constexpr uint32_t version = 1;
+
+        struct Dependency
+        {
+            std::string path;
+            uint64_t size = 0;
+            int64_t modification_time = 0;
+        };
+
+        [[nodiscard]] static std::optional<Dependency> describe(const std::string& path)
+        {
+            std::error_code error;
+            auto size = std::filesystem::file_size(path, error);
+            if(error) {
+                return std::nullopt;
+            }
+            auto modification_time = std::filesystem::last_write_time(path, error);
+            if(error) {
+                return std::nullopt;
+            }
+            return Dependency{path, size, static_cast<int64_t>(modification_time.time_since_epoch().count())};
+        }
+
+    public:
+        /*!
+         * Load the environment cached in \p cache_path
+         * @param cache_path the cache file
+         * @param config_hash hash of the environment config the cache must have been written from
+         * @return the cached environment, or std::nullopt if there is no usable cache
+         */
+        [[nodiscard]] static std::optional<Environment<value_type>> Load(const std::string& cache_path, uint64_t config_hash)
+        {
+            if(!std::filesystem::exists(cache_path)) {
+                return std::nullopt;
+            }
+            try {
+                utility::MappedFile file(cache_path);
+                utility::BinaryReader reader(file.bytes());
+                if(reader.read<uint64_t>() != magic || reader.read<uint32_t>() != version ||
+                   reader.read<uint32_t>() != sizeof(value_type) || reader.read<uint64_t>() != config_hash) {
+                    return std::nullopt;
+                }
+                auto dependency_count = reader.read<uint64_t>();
+                for(uint64_t i = 0; i < dependency_count; i++) {
+                    Dependency cached;
+                    cached.path = reader.readString();
+                    cached.size = reader.read<uint64_t>();
+                    cached.modification_time = reader.read<int64_t>();
+                    std::optional<Dependency> current = describe(cached.path);
+                    if(!current || current->size != cached.size || current->modification_time != cached.modification_time) {
+                        return std::nullopt;
+                    }
+                }
+                Environment<value_type> environment;
+                environment.readBinary(reader);
+                if(!reader.atEnd()) {
+                    return std::nullopt;
+                }
+                return environment;
+            } catch(std::exception&) {
+                // a damaged cache is only a miss, the environment is rebuilt from its config
+                return std::nullopt;
+            }
+        }
+
+        /*!
+         * Write \p environment to \p cache_path. The file is written next to \p cache_path and then renamed over it, so
+         * a concurrent or interrupted run never sees a partial cache.
+         * @param cache_path the cache file
+         * @param config_hash hash of the environment config \p environment was built from
+         * @param environment the environment to cache
+         * @param dependencies files, other than the config, that \p environment was built from. see FindDependencies
+         * @return false if the environment can't be cached or the file couldn't be written
+         */
+        static bool Save(const std::string& cache_path, uint64_t config_hash, const Environment<value_type>& environment,
+                         const std::vector<std::string>& dependencies)
+        {
+            utility::BinaryWriter writer;
+            writer.write(magic);
+            writer.write(version);
+            writer.write<uint32_t>(sizeof(value_type));
+            writer.write(config_hash);
+            writer.write<uint64_t>(dependencies.size());
+            for(const std::string& path : dependencies) {
+                std::optional<Dependency> dependency = describe(path);
+                if(!dependency) {
+                    return false;
+                }
+                writer.writeString(dependency->path);
+                writer.write(dependency->size);
+                writer.write(dependency->modification_time);
+            }
+            if(!environment.writeBinary(writer)) {
+                return false;
+            }
+
+            std::string temporary_path = cache_path + ".tmp";
+            {
+                std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+                if(!file.is_open()) {
+                    return false;
+                }
+                const std::vector<char>& bytes = writer.getBytes();
+                file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+                if(!file) {
+                    std::remove(temporary_path.c_str());
+                    return false;
+                }
+            }
+            std::error_code error;
+            std::filesystem::rename(temporary_path, cache_path, error);
+            if(error) {
+                std::remove(temporary_path.c_str());
+                return false;
+            }
+            return true;
+        }
+
+        /*!
+         * @param environment_config json config of the environment
+         * @return the mesh files referred to by the geometry of \p environment_config
+         */
+        [[nodiscard]] static std::vector<std::string> FindDependencies(const nlohmann::json& environment_config)
+        {
+            std::vector<std::string> dependencies;
+            if(!environment_config.contains("geometry")) {
+                return dependencies;
+            }
+            for(const auto& geometry_json : environment_config.at("geometry")) {
+                if(geometry_json.contains("file")) {
+                    dependencies.push_back(geometry_json.at("file").get<std::string>());
+                }
+            }
+            return dependencies;
+        }
+    };
+}
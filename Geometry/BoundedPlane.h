@@ -5,7 +5,9 @@
 
 #pragma once
 
+#include <cmath>
 #include <optional>
+#include <stdexcept>
 
 #include "Geometry.h"
 #include "Point_X.h"
@@ -14,12 +16,19 @@
 #include "json.h"
 #include "LinearAlgebraTypeTraits.h"
 #include "LinearAlgebraJsonParser.h"
+#include "Statistics.h"
+#include "BinaryStream.h"
 
 namespace geometry
 {
     using namespace linear_algebra_core;
     using namespace color_core;
 
+    /*!
+     * A rectangle of the given width and height centered on a point. The width runs along a tangent to the plane and the
+     * height along the bitangent, both rotated about the normal by the rotation angle (in radians). At a rotation of 0,
+     * the tangent is horizontal: up x normal, where up is +y. For planes facing straight up or down it is +x.
+     */
     template<IsFloatingPoint value_type>
     class BoundedPlane : public Geometry<value_type>
     {
@@ -27,6 +36,7 @@ namespace geometry
         using Ray_3 = Ray<3, value_type>;
         using Point_3 = Point_X<3, value_type>;
         using Vector_3 = Vector_X<3, value_type>;
+        using BoundingBox_3 = BoundingBox<3, value_type>;
 
         Point_3  m_center{};
         Vector_3 m_normal{};
@@ -34,6 +44,37 @@ namespace geometry
         value_type   m_width{};
         value_type   m_height{};
         Color    m_color{};
+        // orthonormal frame of the plane, rotated by m_rotationAngle. derived from the members above by precompute
+        Vector_3 m_tangent{};
+        Vector_3 m_bitangent{};
+        value_type m_inverse_width{};
+        value_type m_inverse_height{};
+
+        /*!
+         * Derive the tangent frame from the normal and rotation angle
+         * @throws std::invalid_argument if the normal has no direction
+         */
+        void precompute()
+        {
+            if(m_normal.getMagnitude() == 0) {
+                throw std::invalid_argument("the normal of a bounded plane cannot be the zero vector");
+            }
+            m_normal.normalize();
+            // close to vertical normals use a different reference, so the cross product stays well conditioned
+            static constexpr auto vertical_threshold = static_cast<value_type>(0.999);
+            Vector_3 reference = std::abs(m_normal[1]) < vertical_threshold
+                               ? Vector_3(static_cast<value_type>(0), static_cast<value_type>(1), static_cast<value_type>(0))
+                               : Vector_3(static_cast<value_type>(0), static_cast<value_type>(0), -m_normal[1]);
+            Vector_3 tangent = reference.cross(m_normal).getUnitVector();
+            Vector_3 bitangent = m_normal.cross(tangent);
+
+            value_type cosine = std::cos(m_rotationAngle);
+            value_type sine = std::sin(m_rotationAngle);
+            m_tangent = tangent * cosine + bitangent * sine;
+            m_bitangent = bitangent * cosine - tangent * sine;
+            m_inverse_width = m_width > 0 ? 1 / m_width : 0;
+            m_inverse_height = m_height > 0 ? 1 / m_height : 0;
+        }
 
     public:
         BoundedPlane() = default;
@@ -45,8 +86,11 @@ namespace geometry
 
         BoundedPlane(const Point_3& plane_center, const Vector_3& plane_normal, const Color& color,
                      value_type width, value_type height, value_type rotationAngle)
-                     : m_center(plane_center), m_normal(plane_normal.getUnitVector()), m_color(color),
-                       m_width(width), m_height(height), m_rotationAngle(rotationAngle) { }
+                     : m_center(plane_center), m_normal(plane_normal), m_rotationAngle(rotationAngle),
+                       m_width(width), m_height(height), m_color(color)
+        {
+            precompute();
+        }
 
         /*!
          * Determines if the given /p ray intersects this plane.
@@ -60,25 +104,53 @@ namespace geometry
         }
 
         /*!
-         * Determines if the given /p ray intersects this plane and returns the intersection point.
+         * Determines if the given /p ray hits this plane within its bounds and closer than \p record.t, and narrows
+         * \p record.t to the hit if so. \p record.uv is set to where the hit is across the width and height of the plane,
+         * from 0 to 1.
          * @param ray The ray to check for intersection
-         * @return a std::optional containing the intersection point, if it exists. containing nothing, otherwise.
+         * @param record the closest hit found so far
+         * @return true if \p record was updated
          * @details uses the solution described here: https://www.scratchapixel.com/lessons/3d-basic-rendering/minimal-ray-tracer-rendering-simple-shapes/ray-plane-and-ray-disk-intersection
          */
-        [[nodiscard]] std::optional<Point_3> getIntersectionPoint(const Ray_3& ray) const override
+        [[nodiscard]] bool intersect(const Ray_3& ray, HitRecord<value_type>& record) const override
         {
+            utility::count(utility::Counter::BoundedPlaneTests);
             value_type denominator = m_normal * ray.getDirection();
-            static const value_type epsilon = 1e-6;
+            static constexpr auto epsilon = static_cast<value_type>(1e-6);
             if(denominator <= epsilon) {
-                return std::nullopt;
+                return false;
             }
             Vector_3 ray_origin_to_plane_center = m_center - ray.getOrigin();
             value_type t = (ray_origin_to_plane_center * m_normal) / denominator;
-            Point_3 intersection_point = ray * t;
+            if(t < 0 || t >= record.t) {
+                return false;
+            }
+
+            Vector_3 center_to_hit = (ray * t) - m_center;
+            value_type along_width = center_to_hit * m_tangent;
+            value_type along_height = center_to_hit * m_bitangent;
+            if(std::abs(along_width) * 2 > m_width || std::abs(along_height) * 2 > m_height) {
+                return false;
+            }
 
-            //TODO: figure out if the intersection point is within the plane bounds
+            record.t = t;
+            static constexpr auto half = static_cast<value_type>(0.5);
+            record.uv = Point_X<2, value_type>(along_width * m_inverse_width + half, along_height * m_inverse_height + half);
+            return true;
+        }
 
-            return { intersection_point };
+        /*!
+         * Determines if the given /p ray intersects this plane and returns the intersection point.
+         * @param ray The ray to check for intersection
+         * @return a std::optional containing the intersection point, if it exists. containing nothing, otherwise.
+         */
+        [[nodiscard]] std::optional<Point_3> getIntersectionPoint(const Ray_3& ray) const override
+        {
+            HitRecord<value_type> record;
+            if(!intersect(ray, record)) {
+                return std::nullopt;
+            }
+            return {ray * record.t};
         }
 
         /*!
@@ -101,6 +173,23 @@ namespace geometry
             return m_normal;
         }
 
+        /*!
+         * @return the box enclosing the four corners of the plane
+         */
+        [[nodiscard]] std::optional<BoundingBox_3> getBoundingBox() const override
+        {
+            Vector_3 half_width = m_tangent * (m_width / 2);
+            Vector_3 half_height = m_bitangent * (m_height / 2);
+            BoundingBox_3 result(m_center + half_width + half_height, m_center - half_width - half_height);
+            result.expand(m_center + half_width - half_height);
+            return result.expand(m_center - half_width + half_height);
+        }
+
+        /*!
+         * @return The plane center
+         */
+        [[nodiscard]] Point_3 getCentroid() const override { return m_center; }
+
         /*!
          * Construct a plane from the given \p json_node
          * @param json_node the json containing the parameters to construct the plane
@@ -159,6 +248,34 @@ namespace geometry
             m_width = width;
             m_height = height;
             m_rotationAngle = rotationAngle;
+            precompute();
+        }
+
+        /*!
+         * Write the state of the plane for the scene cache. See GeometryBuilder::ToBinary
+         */
+        void writeBinary(utility::BinaryWriter& writer) const
+        {
+            writer.write(m_center);
+            writer.write(m_normal);
+            writer.write(m_rotationAngle);
+            writer.write(m_width);
+            writer.write(m_height);
+            writer.write(m_color);
+        }
+
+        /*!
+         * Read back the state written by writeBinary
+         */
+        void readBinary(utility::BinaryReader& reader)
+        {
+            m_center = reader.read<Point_3>();
+            m_normal = reader.read<Vector_3>();
+            m_rotationAngle = reader.read<value_type>();
+            m_width = reader.read<value_type>();
+            m_height = reader.read<value_type>();
+            m_color = reader.read<Color>();
+            precompute();
         }
 
         /*!
@@ -186,5 +303,15 @@ namespace geometry
          * @return The plane rotation angle
          */
         [[nodiscard]] value_type getRotationAngle() const { return m_rotationAngle; }
+
+        /*!
+         * @return unit vector in the plane along its width
+         */
+        [[nodiscard]] Vector_3 getTangent() const { return m_tangent; }
+
+        /*!
+         * @return unit vector in the plane along its height
+         */
+        [[nodiscard]] Vector_3 getBitangent() const { return m_bitangent; }
     };
 }
\ No newline at end of file
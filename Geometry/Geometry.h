@@ -1,8 +1,11 @@
 #pragma once
+#include <cstdint>
 #include <optional>
 #include "LinearAlgebraTypeTraits.h"
 #include "Point_X.h"
 #include "Ray.h"
+#include "BoundingBox.h"
+#include "HitRecord.h"
 #include "Color.h"
 #include "json.h"
 
@@ -10,6 +13,17 @@ namespace geometry
 {
     using namespace linear_algebra_core;
 
+    /*!
+     * One element of a piece of geometry, i.e. a single triangle of a mesh, as indexed by acceleration structures
+     */
+    struct ElementReference
+    {
+        // index of the geometry in the container it was indexed from
+        uint32_t geometry;
+        // index of the element within the geometry, always 0 for geometry made of a single element
+        uint32_t element;
+    };
+
     template<IsFloatingPoint value_type>
     class Geometry
     {
@@ -17,13 +31,85 @@ namespace geometry
         using Ray_3 = Ray<3, value_type>;
         using Point_3 = Point_X<3, value_type>;
         using Vector_3 = Vector_X<3, value_type>;
+        using BoundingBox_3 = BoundingBox<3, value_type>;
 
                       virtual ~Geometry() = default;
         [[nodiscard]] virtual bool intersects(const Ray_3& ray) const = 0;
+        // if the ray hits this geometry in [0, record.t), narrows record.t to the hit and returns true. geometry made of
+        // several elements also sets record.element_id
+        [[nodiscard]] virtual bool intersect(const Ray_3& ray, HitRecord<value_type>& record) const = 0;
         [[nodiscard]] virtual std::optional<Point_3> getIntersectionPoint(const Ray_3& ray) const = 0;
         // TODO: currently just assuming the given point is retrieved from the getIntersectionPoint function... figure out a better way to do this.
         [[nodiscard]] virtual color_core::Color getColorAt(const Point_3& point) const = 0;
         [[nodiscard]] virtual Vector_3 getNormalAt(const Point_3& point) const = 0;
+        // std::nullopt means the geometry is unbounded (i.e. an infinite plane) and can't be placed in a spatial index
+        [[nodiscard]] virtual std::optional<BoundingBox_3> getBoundingBox() const = 0;
+        // representative point used to sort geometry when building spatial indexes
+        [[nodiscard]] virtual Point_3 getCentroid() const = 0;
+        [[nodiscard]]         bool isBounded() const { return getBoundingBox().has_value(); }
                       virtual void fromJson(const nlohmann::json& json_node) = 0;
+
+        /*!
+         * Geometry made of many elements (i.e. a triangle mesh) exposes them individually, so acceleration structures
+         * can index each element on its own. Everything else is a single element, the geometry itself.
+         * @return the number of elements
+         */
+        [[nodiscard]] virtual uint32_t getElementCount() const { return 1; }
+
+        /*!
+         * @return the box enclosing \p element, std::nullopt if it is unbounded
+         */
+        [[nodiscard]] virtual std::optional<BoundingBox_3> getElementBoundingBox([[maybe_unused]] uint32_t element) const { return getBoundingBox(); }
+
+        /*!
+         * @return the representative point of \p element, used to sort elements when building spatial indexes
+         */
+        [[nodiscard]] virtual Point_3 getElementCentroid([[maybe_unused]] uint32_t element) const { return getCentroid(); }
+
+        /*!
+         * Like intersect, but only tests \p element
+         * @param element the element to test
+         * @param ray the ray to check for intersection
+         * @param record the closest hit found so far
+         * @return true if \p record was updated
+         */
+        [[nodiscard]] virtual bool intersectElement([[maybe_unused]] uint32_t element, const Ray_3& ray, HitRecord<value_type>& record) const
+        {
+            return intersect(ray, record);
+        }
+
+        /*!
+         * Any hit query for shadow and visibility rays. Geometry should override it where it can answer more cheaply
+         * than by finding the closest hit.
+         * @param ray the ray to check for intersection
+         * @param t_max the furthest ray parameter of interest
+         * @return true if the \p ray hits this geometry anywhere in [0, \p t_max)
+         */
+        [[nodiscard]] virtual bool occludes(const Ray_3& ray, value_type t_max) const
+        {
+            HitRecord<value_type> record;
+            record.t = t_max;
+            return intersect(ray, record);
+        }
+
+        /*!
+         * Like occludes, but only tests \p element
+         */
+        [[nodiscard]] virtual bool occludesElement([[maybe_unused]] uint32_t element, const Ray_3& ray, value_type t_max) const
+        {
+            return occludes(ray, t_max);
+        }
+
+        /*!
+         * Fill in the point and normal (and anything else the geometry knows) of a hit found by intersect or
+         * intersectElement
+         * @param ray the ray that was passed to intersect
+         * @param record the record of the hit on this geometry
+         */
+        virtual void completeHitRecord(const Ray_3& ray, HitRecord<value_type>& record) const
+        {
+            record.point = ray * record.t;
+            record.normal = getNormalAt(record.point);
+        }
     };
 }
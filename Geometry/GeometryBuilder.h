@@ -3,22 +3,59 @@
 //
 
 #pragma once
+#include <cstdint>
 #include <memory>
+#include <stdexcept>
+#include <typeinfo>
 #include "LinearAlgebraTypeTraits.h"
 #include "Geometry.h"
 #include "Sphere.h"
 #include "Plane.h"
 #include "Triangle.h"
 #include "BoundedPlane.h"
+#include "TriangleMesh.h"
+#include "MeshLoader.h"
+#include "BinaryStream.h"
 
 namespace geometry
 {
     template<IsArithmetic value_type>
     class GeometryBuilder
     {
+    private:
+        // identifies the type of each piece of geometry in binary form. Never reorder, only append
+        enum class BinaryTag : uint8_t
+        {
+            Sphere,
+            Plane,
+            BoundedPlane,
+            Triangle,
+            TriangleMesh
+        };
+
+        template<typename Concrete>
+        [[nodiscard]] static bool writeIfExactly(const Geometry<value_type>& geometry, BinaryTag tag, utility::BinaryWriter& writer)
+        {
+            if(typeid(geometry) != typeid(Concrete)) {
+                return false;
+            }
+            writer.write(tag);
+            static_cast<const Concrete&>(geometry).writeBinary(writer);
+            return true;
+        }
+
+        template<typename Concrete>
+        [[nodiscard]] static std::shared_ptr<Geometry<value_type>> read(utility::BinaryReader& reader)
+        {
+            auto result = std::make_shared<Concrete>();
+            result->readBinary(reader);
+            return result;
+        }
+
     public:
         /*!
-         * Create a geometry object from the given \p json_object
+         * Create a geometry object from the given \p json_object. A "triangle_mesh" with a "file" key is loaded from
+         * that OBJ or PLY file, see MeshLoader
          * @param json_object the json node to create the object from
          * @return A pointer to the newly constructed Geometry object
          */
@@ -34,11 +71,48 @@ namespace geometry
                 result = std::make_shared<BoundedPlane<value_type>>();
             } else if(object_type == "triangle") {
                 result = std::make_shared<Triangle<value_type>>();
+            } else if(object_type == "triangle_mesh") {
+                if(json_object.contains("file")) {
+                    return MeshLoader<value_type>::FromJson(json_object);
+                }
+                result = std::make_shared<TriangleMesh<value_type>>();
             } else {
-                throw std::invalid_argument("json geometry objects must contain a 'type' field with one of the following values: \n [sphere, plane, bounded_plane, triangle]");
+                throw std::invalid_argument("json geometry objects must contain a 'type' field with one of the following values: \n [sphere, plane, bounded_plane, triangle, triangle_mesh]");
             }
             result->fromJson(json_object);
             return result;
         }
+
+        /*!
+         * Write \p geometry in binary form, as used by the scene cache
+         * @param geometry the geometry to write
+         * @param writer where to write it
+         * @return false, without writing anything, if \p geometry isn't one of the built in types
+         */
+        [[nodiscard]] static bool ToBinary(const Geometry<value_type>& geometry, utility::BinaryWriter& writer)
+        {
+            return writeIfExactly<Sphere<value_type>>(geometry, BinaryTag::Sphere, writer) ||
+                   writeIfExactly<Plane<value_type>>(geometry, BinaryTag::Plane, writer) ||
+                   writeIfExactly<BoundedPlane<value_type>>(geometry, BinaryTag::BoundedPlane, writer) ||
+                   writeIfExactly<Triangle<value_type>>(geometry, BinaryTag::Triangle, writer) ||
+                   writeIfExactly<TriangleMesh<value_type>>(geometry, BinaryTag::TriangleMesh, writer);
+        }
+
+        /*!
+         * Read back a piece of geometry written by ToBinary
+         * @param reader where to read the geometry from
+         * @return A pointer to the newly constructed Geometry object
+         */
+        static std::shared_ptr<Geometry<value_type>> FromBinary(utility::BinaryReader& reader)
+        {
+            switch(reader.read<BinaryTag>()) {
+                case BinaryTag::Sphere:       return read<Sphere<value_type>>(reader);
+                case BinaryTag::Plane:        return read<Plane<value_type>>(reader);
+                case BinaryTag::BoundedPlane: return read<BoundedPlane<value_type>>(reader);
+                case BinaryTag::Triangle:     return read<Triangle<value_type>>(reader);
+                case BinaryTag::TriangleMesh: return read<TriangleMesh<value_type>>(reader);
+            }
+            throw std::runtime_error("unknown geometry type in binary data");
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "LinearAlgebraTypeTraits.h"
+#include "Point_X.h"
+#include "Vector_X.h"
+
+namespace geometry
+{
+    using namespace linear_algebra_core;
+
+    template<IsFloatingPoint value_type>
+    class Geometry;
+
+    /*!
+     * Everything known about the closest intersection found so far along a ray. Geometry::intersect only narrows
+     * \p t (and \p uv where it comes for free), the rest is filled in by Geometry::completeHitRecord once the closest
+     * hit is known.
+     */
+    template<IsFloatingPoint value_type>
+    struct HitRecord
+    {
+        static constexpr uint32_t invalid_id = std::numeric_limits<uint32_t>::max();
+
+        // ray parameter of the hit. Doubles as the upper bound when searching for a closer hit
+        value_type t = std::numeric_limits<value_type>::max();
+        Point_X<3, value_type>  point{};
+        Vector_X<3, value_type> normal{};
+        // surface coordinates of the hit, meaning depends on the type of geometry that was hit
+        Point_X<2, value_type>  uv{};
+        uint32_t primitive_id = invalid_id;
+        // which element of the primitive was hit, see Geometry::getElementCount
+        uint32_t element_id = 0;
+        const Geometry<value_type>* geometry = nullptr;
+
+        /*!
+         * @return true if a hit has been recorded. Valid during the search, before geometry is filled in
+         */
+        [[nodiscard]] bool hasHit() const { return primitive_id != invalid_id; }
+    };
+}
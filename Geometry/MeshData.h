@@ -0,0 +1,31 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "LinearAlgebraTypeTraits.h"
+#include "Point_X.h"
+#include "Vector_X.h"
+
+namespace geometry
+{
+    using namespace linear_algebra_core;
+
+    /*!
+     * The buffers of a triangle mesh as read from a file, ready to be moved into a TriangleMesh
+     */
+    template<IsFloatingPoint value_type>
+    struct MeshData
+    {
+        std::vector<Point_X<3, value_type>> vertices;
+        // three per triangle
+        std::vector<uint32_t> indices;
+        // either empty, or one per vertex
+        std::vector<Vector_X<3, value_type>> normals;
+        std::vector<Point_X<2, value_type>> uvs;
+    };
+}
@@ -0,0 +1,91 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "LinearAlgebraTypeTraits.h"
+#include "Color.h"
+#include "json.h"
+#include "MappedFile.h"
+#include "MeshData.h"
+#include "OBJMeshParser.h"
+#include "PLYMeshParser.h"
+#include "TriangleMesh.h"
+
+namespace geometry
+{
+    using namespace color_core;
+
+    /*!
+     * Loads triangle meshes from OBJ and binary PLY files. The file is memory mapped and parsed in parallel chunks
+     * straight into the mesh buffers, without going through json.
+     */
+    template<IsFloatingPoint value_type>
+    class MeshLoader
+    {
+    public:
+        /*!
+         * Read the mesh in \p filepath, choosing the format from its suffix
+         * @param filepath path to an .obj or .ply file
+         * @return the buffers of the mesh
+         * @throws std::invalid_argument if the suffix isn't a supported format
+         * @throws std::runtime_error if the file can't be read or is malformed
+         */
+        [[nodiscard]] static MeshData<value_type> LoadData(const std::string& filepath)
+        {
+            std::string suffix = filepath.substr(filepath.find_last_of('.') + 1);
+            std::transform(suffix.begin(), suffix.end(), suffix.begin(), [](unsigned char c) { return std::tolower(c); });
+            if(suffix != "obj" && suffix != "ply") {
+                throw std::invalid_argument("mesh file type must be one of the following values: \n [obj, ply]. got " + suffix);
+            }
+
+            utility::MappedFile file(filepath);
+            if(suffix == "obj") {
+                return OBJMeshParser<value_type>::Parse(file.bytes(), filepath);
+            }
+            return PLYMeshParser<value_type>::Parse(file.bytes(), filepath);
+        }
+
+        /*!
+         * Load the mesh in \p filepath. See LoadData
+         * @param filepath path to an .obj or .ply file
+         * @param color the color of the whole mesh
+         * @return the mesh
+         */
+        [[nodiscard]] static std::shared_ptr<TriangleMesh<value_type>> Load(const std::string& filepath, const Color& color)
+        {
+            MeshData<value_type> data = LoadData(filepath);
+            return std::make_shared<TriangleMesh<value_type>>(std::move(data.vertices), std::move(data.indices), color,
+                                                              std::move(data.normals), std::move(data.uvs));
+        }
+
+        /*!
+         * Load the mesh described by a json node of the form { "file": "path/to/mesh.ply", "color": [R, G, B] }
+         * @param json_node the json containing the path and color of the mesh
+         * @return the mesh
+         */
+        [[nodiscard]] static std::shared_ptr<TriangleMesh<value_type>> FromJson(const nlohmann::json& json_node)
+        {
+            std::string filepath;
+            Color color;
+            try {
+                filepath = json_node.at("file").get<std::string>();
+            } catch(std::exception& e) {
+                throw std::invalid_argument("Could not find the required 'file' key.");
+            }
+            try {
+                color.fromJson(json_node.at("color"));
+            } catch(std::exception& e) {
+                throw std::invalid_argument("Could not find the required 'color' key.");
+            }
+            return Load(filepath, color);
+        }
+    };
+}
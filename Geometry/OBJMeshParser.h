@@ -0,0 +1,353 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "LinearAlgebraTypeTraits.h"
+#include "MeshData.h"
+#include "Parallel.h"
+
+namespace geometry
+{
+    /*!
+     * Parses the geometry of Wavefront OBJ files: vertex positions, texture coordinates and normals, and faces, which
+     * are triangulated as fans. Everything else (materials, groups, lines, ...) is ignored.
+     *
+     * The text is split into chunks at line boundaries that are parsed in parallel. A first pass counts the vertex
+     * attributes in each chunk, so the second pass knows where each chunk's vertices go and can resolve relative
+     * (negative) indices without waiting on the chunks before it.
+     */
+    template<IsFloatingPoint value_type>
+    class OBJMeshParser
+    {
+    private:
+        static constexpr uint32_t no_index = std::numeric_limits<uint32_t>::max();
+        // chunks smaller than this aren't worth a thread
+        static constexpr size_t min_chunk_size = 1 << 20;
+
+        struct AttributeCounts
+        {
+            size_t positions = 0;
+            size_t uvs = 0;
+            size_t normals = 0;
+        };
+
+        // the attributes of one corner of a face, as 0 based indices
+        struct Corner
+        {
+            uint32_t position;
+            uint32_t uv;
+            uint32_t normal;
+
+            bool operator==(const Corner& other) const = default;
+        };
+
+        struct CornerHash
+        {
+            size_t operator()(const Corner& corner) const
+            {
+                uint64_t key = (static_cast<uint64_t>(corner.position) * 0x9E3779B97F4A7C15ull) ^
+                               (static_cast<uint64_t>(corner.uv) * 0xC2B2AE3D27D4EB4Full) ^ corner.normal;
+                return static_cast<size_t>(key ^ (key >> 29));
+            }
+        };
+
+        [[nodiscard]] static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+        [[nodiscard]] static const char* skipSpaces(const char* current, const char* end)
+        {
+            while(current < end && isSpace(*current)) {
+                current++;
+            }
+            return current;
+        }
+
+        /*!
+         * Call \p visit with the first non blank character and the end (excluding the newline) of every line in
+         * [\p begin, \p end)
+         */
+        template<typename Visitor>
+        static void forEachLine(const char* begin, const char* end, Visitor&& visit)
+        {
+            while(begin < end) {
+                const auto* newline = static_cast<const char*>(std::memchr(begin, '\n', static_cast<size_t>(end - begin)));
+                const char* line_end = newline != nullptr ? newline : end;
+                visit(skipSpaces(begin, line_end), line_end);
+                begin = line_end + 1;
+            }
+        }
+
+        /*!
+         * @return the keyword at the start of a line: "v", "vt", "vn", "f", or something else
+         */
+        [[nodiscard]] static std::string_view keyword(const char* line, const char* end)
+        {
+            const char* current = line;
+            while(current < end && !isSpace(*current)) {
+                current++;
+            }
+            return {line, static_cast<size_t>(current - line)};
+        }
+
+        [[nodiscard]] static std::runtime_error parseError(const std::string& name, const char* line, const char* end)
+        {
+            return std::runtime_error(name + ": could not parse the line '" + std::string(line, end) + "'");
+        }
+
+        template<typename Number>
+        [[nodiscard]] static bool parseNumber(const char*& current, const char* end, Number& value)
+        {
+            current = skipSpaces(current, end);
+            if(current < end && *current == '+') {
+                current++;
+            }
+            std::from_chars_result result = std::from_chars(current, end, value);
+            if(result.ec != std::errc()) {
+                return false;
+            }
+            current = result.ptr;
+            return true;
+        }
+
+        /*!
+         * Parse the next \p N numbers of a line into \p values
+         */
+        template<size_t N>
+        [[nodiscard]] static bool parseNumbers(const char* current, const char* end, std::array<value_type, N>& values)
+        {
+            for(value_type& value : values) {
+                if(!parseNumber(current, end, value)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /*!
+         * Turn a 1 based (or negative, relative to the \p count attributes seen so far) index into a 0 based one
+         */
+        [[nodiscard]] static bool resolveIndex(int64_t index, size_t count, uint32_t& resolved)
+        {
+            int64_t zero_based = index > 0 ? index - 1 : static_cast<int64_t>(count) + index;
+            if(index == 0 || zero_based < 0 || zero_based >= static_cast<int64_t>(count)) {
+                return false;
+            }
+            resolved = static_cast<uint32_t>(zero_based);
+            return true;
+        }
+
+        /*!
+         * Parse a face corner in one of the forms "p", "p/t", "p//n", or "p/t/n"
+         */
+        [[nodiscard]] static bool parseCorner(const char*& current, const char* end, const AttributeCounts& seen, Corner& corner)
+        {
+            int64_t index = 0;
+            corner = {no_index, no_index, no_index};
+            if(!parseNumber(current, end, index) || !resolveIndex(index, seen.positions, corner.position)) {
+                return false;
+            }
+            if(current < end && *current == '/') {
+                current++;
+                if(current < end && *current != '/') {
+                    if(!parseNumber(current, end, index) || !resolveIndex(index, seen.uvs, corner.uv)) {
+                        return false;
+                    }
+                }
+                if(current < end && *current == '/') {
+                    current++;
+                    if(!parseNumber(current, end, index) || !resolveIndex(index, seen.normals, corner.normal)) {
+                        return false;
+                    }
+                }
+            }
+            return current >= end || isSpace(*current);
+        }
+
+        /*!
+         * Move each chunk boundary forward to the start of the next line
+         */
+        [[nodiscard]] static std::vector<std::pair<size_t, size_t>> splitLines(std::span<const char> text)
+        {
+            std::vector<std::pair<size_t, size_t>> ranges = utility::splitRange(text.size(), min_chunk_size);
+            for(size_t i = 1; i < ranges.size(); i++) {
+                size_t begin = ranges[i - 1].second;
+                const auto* newline = static_cast<const char*>(std::memchr(text.data() + begin, '\n', text.size() - begin));
+                begin = newline != nullptr ? static_cast<size_t>(newline - text.data()) + 1 : text.size();
+                ranges[i - 1].second = std::max(begin, ranges[i - 1].first);
+                ranges[i].first = ranges[i - 1].second;
+                ranges[i].second = std::max(ranges[i].second, ranges[i].first);
+            }
+            return ranges;
+        }
+
+    public:
+        /*!
+         * @param text the contents of an OBJ file
+         * @param name the name of the file, used in error messages
+         * @return the mesh in the file. Normals and uvs are only kept if every face corner has them
+         * @throws std::runtime_error if the file is malformed
+         */
+        [[nodiscard]] static MeshData<value_type> Parse(std::span<const char> text, const std::string& name)
+        {
+            std::vector<std::pair<size_t, size_t>> ranges = splitLines(text);
+
+            // first pass: count the attributes in each chunk
+            std::vector<AttributeCounts> counts(ranges.size());
+            utility::parallelFor(ranges.size(), [&](size_t chunk) {
+                forEachLine(text.data() + ranges[chunk].first, text.data() + ranges[chunk].second, [&](const char* line, const char* end) {
+                    std::string_view type = keyword(line, end);
+                    if(type == "v") {
+                        counts[chunk].positions++;
+                    } else if(type == "vt") {
+                        counts[chunk].uvs++;
+                    } else if(type == "vn") {
+                        counts[chunk].normals++;
+                    }
+                });
+            });
+
+            std::vector<AttributeCounts> offsets(ranges.size());
+            AttributeCounts total;
+            for(size_t chunk = 0; chunk < ranges.size(); chunk++) {
+                offsets[chunk] = total;
+                total.positions += counts[chunk].positions;
+                total.uvs += counts[chunk].uvs;
+                total.normals += counts[chunk].normals;
+            }
+            if(total.positions > no_index) {
+                throw std::runtime_error(name + ": meshes can have at most 2^32 - 1 vertices");
+            }
+
+            // second pass: parse every chunk straight into the shared attribute arrays
+            std::vector<Point_X<3, value_type>> positions(total.positions);
+            std::vector<Point_X<2, value_type>> uvs(total.uvs);
+            std::vector<Vector_X<3, value_type>> normals(total.normals);
+            std::vector<std::vector<Corner>> corners(ranges.size());
+            utility::parallelFor(ranges.size(), [&](size_t chunk) {
+                AttributeCounts seen = offsets[chunk];
+                std::vector<Corner> face;
+                forEachLine(text.data() + ranges[chunk].first, text.data() + ranges[chunk].second, [&](const char* line, const char* end) {
+                    std::string_view type = keyword(line, end);
+                    const char* arguments = line + type.size();
+                    if(type == "v") {
+                        std::array<value_type, 3> values{};
+                        if(!parseNumbers(arguments, end, values)) {
+                            throw parseError(name, line, end);
+                        }
+                        positions[seen.positions++] = Point_X<3, value_type>(values);
+                    } else if(type == "vt") {
+                        value_type u = 0, v = 0;
+                        if(!parseNumber(arguments, end, u)) {
+                            throw parseError(name, line, end);
+                        }
+                        // the v coordinate is optional
+                        if(!parseNumber(arguments, end, v)) {
+                            v = 0;
+                        }
+                        uvs[seen.uvs++] = Point_X<2, value_type>(u, v);
+                    } else if(type == "vn") {
+                        std::array<value_type, 3> values{};
+                        if(!parseNumbers(arguments, end, values)) {
+                            throw parseError(name, line, end);
+                        }
+                        normals[seen.normals++] = Vector_X<3, value_type>(values);
+                    } else if(type == "f") {
+                        face.clear();
+                        const char* current = skipSpaces(arguments, end);
+                        while(current < end) {
+                            Corner corner{};
+                            if(!parseCorner(current, end, seen, corner)) {
+                                throw parseError(name, line, end);
+                            }
+                            face.push_back(corner);
+                            current = skipSpaces(current, end);
+                        }
+                        if(face.size() < 3) {
+                            throw parseError(name, line, end);
+                        }
+                        for(size_t i = 1; i + 1 < face.size(); i++) {
+                            corners[chunk].insert(corners[chunk].end(), {face[0], face[i], face[i + 1]});
+                        }
+                    }
+                });
+            });
+
+            return assemble(std::move(positions), std::move(uvs), std::move(normals), corners, name);
+        }
+
+    private:
+        /*!
+         * Build the single index mesh from the separately indexed face corners
+         */
+        [[nodiscard]] static MeshData<value_type> assemble(std::vector<Point_X<3, value_type>> positions,
+                                                           std::vector<Point_X<2, value_type>> uvs,
+                                                           std::vector<Vector_X<3, value_type>> normals,
+                                                           const std::vector<std::vector<Corner>>& corners,
+                                                           const std::string& name)
+        {
+            bool every_corner_has_uv = !uvs.empty();
+            bool every_corner_has_normal = !normals.empty();
+            size_t corner_count = 0;
+            for(const std::vector<Corner>& chunk : corners) {
+                corner_count += chunk.size();
+                for(const Corner& corner : chunk) {
+                    every_corner_has_uv = every_corner_has_uv && corner.uv != no_index;
+                    every_corner_has_normal = every_corner_has_normal && corner.normal != no_index;
+                }
+            }
+
+            MeshData<value_type> result;
+            result.indices.reserve(corner_count);
+            if(!every_corner_has_uv && !every_corner_has_normal) {
+                // only positions, so the corners already index the vertices
+                for(const std::vector<Corner>& chunk : corners) {
+                    for(const Corner& corner : chunk) {
+                        result.indices.push_back(corner.position);
+                    }
+                }
+                result.vertices = std::move(positions);
+                return result;
+            }
+
+            // every distinct combination of attributes becomes a vertex
+            std::unordered_map<Corner, uint32_t, CornerHash> vertex_of;
+            vertex_of.reserve(positions.size());
+            for(const std::vector<Corner>& chunk : corners) {
+                for(Corner corner : chunk) {
+                    corner.uv = every_corner_has_uv ? corner.uv : no_index;
+                    corner.normal = every_corner_has_normal ? corner.normal : no_index;
+                    auto [vertex, inserted] = vertex_of.try_emplace(corner, static_cast<uint32_t>(result.vertices.size()));
+                    if(inserted) {
+                        if(result.vertices.size() == no_index) {
+                            throw std::runtime_error(name + ": meshes can have at most 2^32 - 1 vertices");
+                        }
+                        result.vertices.push_back(positions[corner.position]);
+                        if(every_corner_has_uv) {
+                            result.uvs.push_back(uvs[corner.uv]);
+                        }
+                        if(every_corner_has_normal) {
+                            result.normals.push_back(normals[corner.normal]);
+                        }
+                    }
+                    result.indices.push_back(vertex->second);
+                }
+            }
+            return result;
+        }
+    };
+}
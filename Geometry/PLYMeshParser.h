@@ -0,0 +1,448 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "LinearAlgebraTypeTraits.h"
+#include "MeshData.h"
+#include "Parallel.h"
+
+namespace geometry
+{
+    /*!
+     * Parses binary (little or big endian) PLY files. Vertices are read from the "x", "y" and "z" properties of the
+     * "vertex" element, plus "nx", "ny", "nz" and "u", "v" (or "s", "t") if present. Faces are read from the
+     * "vertex_indices" (or "vertex_index") list of the "face" element, and triangulated as fans. Any other elements
+     * and properties are skipped.
+     *
+     * Vertices have a fixed size, so they are decoded in parallel chunks. Faces usually are all triangles, so they are
+     * first decoded in parallel assuming that they are, falling back to a single pass if any of them isn't.
+     */
+    template<IsFloatingPoint value_type>
+    class PLYMeshParser
+    {
+    private:
+        // chunks with fewer items than this aren't worth a thread
+        static constexpr size_t min_chunk_size = 1 << 16;
+
+        enum class Type : uint8_t
+        {
+            Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64
+        };
+
+        struct Property
+        {
+            std::string name;
+            Type type;
+            bool is_list = false;
+            // the type of the element count that precedes a list
+            Type count_type = Type::UInt8;
+        };
+
+        struct Element
+        {
+            std::string name;
+            size_t count = 0;
+            std::vector<Property> properties;
+
+            [[nodiscard]] bool hasLists() const
+            {
+                return std::any_of(properties.begin(), properties.end(), [](const Property& property) { return property.is_list; });
+            }
+
+            [[nodiscard]] std::optional<size_t> find(const std::string& property_name) const
+            {
+                for(size_t i = 0; i < properties.size(); i++) {
+                    if(properties[i].name == property_name) {
+                        return i;
+                    }
+                }
+                return std::nullopt;
+            }
+        };
+
+        [[nodiscard]] static Type TypeFromString(const std::string& type_name, const std::string& name)
+        {
+            if(type_name == "char" || type_name == "int8") { return Type::Int8; }
+            if(type_name == "uchar" || type_name == "uint8") { return Type::UInt8; }
+            if(type_name == "short" || type_name == "int16") { return Type::Int16; }
+            if(type_name == "ushort" || type_name == "uint16") { return Type::UInt16; }
+            if(type_name == "int" || type_name == "int32") { return Type::Int32; }
+            if(type_name == "uint" || type_name == "uint32") { return Type::UInt32; }
+            if(type_name == "float" || type_name == "float32") { return Type::Float32; }
+            if(type_name == "double" || type_name == "float64") { return Type::Float64; }
+            throw std::runtime_error(name + ": unknown PLY property type " + type_name);
+        }
+
+        [[nodiscard]] static size_t sizeOf(Type type)
+        {
+            switch(type) {
+                case Type::Int8: case Type::UInt8:     return 1;
+                case Type::Int16: case Type::UInt16:   return 2;
+                case Type::Int32: case Type::UInt32: case Type::Float32: return 4;
+                case Type::Float64:                    return 8;
+            }
+            return 0;
+        }
+
+        template<typename T>
+        [[nodiscard]] static T load(const char* data, bool swap_bytes)
+        {
+            std::array<char, sizeof(T)> bytes;
+            std::memcpy(bytes.data(), data, sizeof(T));
+            if(swap_bytes) {
+                std::reverse(bytes.begin(), bytes.end());
+            }
+            return std::bit_cast<T>(bytes);
+        }
+
+        /*!
+         * @return the value of type \p type at \p data
+         */
+        template<typename Result>
+        [[nodiscard]] static Result read(const char* data, Type type, bool swap_bytes)
+        {
+            switch(type) {
+                case Type::Int8:    return static_cast<Result>(load<int8_t>(data, swap_bytes));
+                case Type::UInt8:   return static_cast<Result>(load<uint8_t>(data, swap_bytes));
+                case Type::Int16:   return static_cast<Result>(load<int16_t>(data, swap_bytes));
+                case Type::UInt16:  return static_cast<Result>(load<uint16_t>(data, swap_bytes));
+                case Type::Int32:   return static_cast<Result>(load<int32_t>(data, swap_bytes));
+                case Type::UInt32:  return static_cast<Result>(load<uint32_t>(data, swap_bytes));
+                case Type::Float32: return static_cast<Result>(load<float>(data, swap_bytes));
+                case Type::Float64: return static_cast<Result>(load<double>(data, swap_bytes));
+            }
+            return Result{};
+        }
+
+        /*!
+         * The parsed header, and where the data after it starts
+         */
+        struct Header
+        {
+            std::vector<Element> elements;
+            bool swap_bytes = false;
+            size_t data_offset = 0;
+        };
+
+        [[nodiscard]] static Header parseHeader(std::span<const char> bytes, const std::string& name)
+        {
+            static constexpr std::string_view end_marker = "end_header";
+            std::string_view text(bytes.data(), bytes.size());
+            size_t end = text.find(end_marker);
+            if(text.substr(0, 3) != "ply" || end == std::string_view::npos) {
+                throw std::runtime_error(name + ": not a PLY file");
+            }
+            size_t data_offset = text.find('\n', end);
+            if(data_offset == std::string_view::npos) {
+                throw std::runtime_error(name + ": the PLY header isn't followed by any data");
+            }
+
+            Header header;
+            header.data_offset = data_offset + 1;
+            std::istringstream lines{std::string(text.substr(0, end))};
+            std::string line;
+            bool has_format = false;
+            while(std::getline(lines, line)) {
+                std::istringstream words(line);
+                std::string keyword;
+                words >> keyword;
+                if(keyword == "format") {
+                    std::string format;
+                    words >> format;
+                    if(format == "binary_little_endian") {
+                        header.swap_bytes = std::endian::native != std::endian::little;
+                    } else if(format == "binary_big_endian") {
+                        header.swap_bytes = std::endian::native != std::endian::big;
+                    } else {
+                        throw std::runtime_error(name + ": PLY format must be one of the following values: \n [binary_little_endian, binary_big_endian]. got " + format);
+                    }
+                    has_format = true;
+                } else if(keyword == "element") {
+                    Element element;
+                    words >> element.name >> element.count;
+                    header.elements.push_back(element);
+                } else if(keyword == "property") {
+                    if(header.elements.empty()) {
+                        throw std::runtime_error(name + ": PLY property declared before any element");
+                    }
+                    Property property;
+                    std::string type_name;
+                    words >> type_name;
+                    if(type_name == "list") {
+                        std::string count_type_name;
+                        words >> count_type_name >> type_name;
+                        property.is_list = true;
+                        property.count_type = TypeFromString(count_type_name, name);
+                    }
+                    property.type = TypeFromString(type_name, name);
+                    words >> property.name;
+                    header.elements.back().properties.push_back(property);
+                }
+            }
+            if(!has_format) {
+                throw std::runtime_error(name + ": the PLY header has no format line");
+            }
+            return header;
+        }
+
+        [[nodiscard]] static std::runtime_error truncated(const std::string& name)
+        {
+            return std::runtime_error(name + ": the PLY file ends before all of its elements");
+        }
+
+        /*!
+         * @return the size in bytes of the item of \p element at \p data, checking it doesn't run past \p end
+         */
+        [[nodiscard]] static size_t itemSize(const Element& element, const char* data, const char* end, bool swap_bytes, const std::string& name)
+        {
+            size_t size = 0;
+            for(const Property& property : element.properties) {
+                if(property.is_list) {
+                    if(data + size + sizeOf(property.count_type) > end) {
+                        throw truncated(name);
+                    }
+                    auto count = read<int64_t>(data + size, property.count_type, swap_bytes);
+                    if(count < 0) {
+                        throw std::runtime_error(name + ": negative PLY list length");
+                    }
+                    size += sizeOf(property.count_type) + (static_cast<size_t>(count) * sizeOf(property.type));
+                } else {
+                    size += sizeOf(property.type);
+                }
+            }
+            if(data + size > end) {
+                throw truncated(name);
+            }
+            return size;
+        }
+
+        /*!
+         * @return the size in bytes of every item of \p element starting at \p data
+         */
+        [[nodiscard]] static size_t elementSize(const Element& element, const char* data, const char* end, bool swap_bytes, const std::string& name)
+        {
+            if(!element.hasLists()) {
+                size_t stride = propertyOffsets(element).back();
+                if(static_cast<size_t>(end - data) / std::max<size_t>(stride, 1) < element.count) {
+                    throw truncated(name);
+                }
+                return stride * element.count;
+            }
+            size_t size = 0;
+            for(size_t i = 0; i < element.count; i++) {
+                size += itemSize(element, data + size, end, swap_bytes, name);
+            }
+            return size;
+        }
+
+        /*!
+         * @return the offset of each property within an item of \p element, which must not have any lists
+         */
+        [[nodiscard]] static std::vector<size_t> propertyOffsets(const Element& element)
+        {
+            std::vector<size_t> offsets;
+            size_t offset = 0;
+            for(const Property& property : element.properties) {
+                offsets.push_back(offset);
+                offset += sizeOf(property.type);
+            }
+            offsets.push_back(offset);
+            return offsets;
+        }
+
+        /*!
+         * @return the size in bytes of the vertices
+         */
+        static size_t readVertices(const Element& element, const char* data, const char* end, const Header& header,
+                                   MeshData<value_type>& mesh, const std::string& name)
+        {
+            if(element.hasLists()) {
+                throw std::runtime_error(name + ": PLY vertices with list properties are not supported");
+            }
+            auto findAll = [&](std::initializer_list<const char*> names) {
+                std::vector<size_t> result;
+                for(const char* property_name : names) {
+                    if(std::optional<size_t> index = element.find(property_name)) {
+                        result.push_back(index.value());
+                    }
+                }
+                return result.size() == names.size() ? result : std::vector<size_t>{};
+            };
+            std::vector<size_t> position = findAll({"x", "y", "z"});
+            std::vector<size_t> normal = findAll({"nx", "ny", "nz"});
+            std::vector<size_t> uv = findAll({"u", "v"});
+            if(uv.empty()) {
+                uv = findAll({"s", "t"});
+            }
+            if(uv.empty()) {
+                uv = findAll({"texture_u", "texture_v"});
+            }
+            if(position.empty()) {
+                throw std::runtime_error(name + ": PLY vertices must have x, y and z properties");
+            }
+
+            const size_t size = elementSize(element, data, end, header.swap_bytes, name);
+            std::vector<size_t> offsets = propertyOffsets(element);
+            const size_t stride = offsets.back();
+            mesh.vertices.resize(element.count);
+            mesh.normals.resize(normal.empty() ? 0 : element.count);
+            mesh.uvs.resize(uv.empty() ? 0 : element.count);
+
+            auto readProperty = [&](const char* item, size_t property) {
+                return read<value_type>(item + offsets[property], element.properties[property].type, header.swap_bytes);
+            };
+            std::vector<std::pair<size_t, size_t>> ranges = utility::splitRange(element.count, min_chunk_size);
+            utility::parallelFor(ranges.size(), [&](size_t chunk) {
+                for(size_t i = ranges[chunk].first; i < ranges[chunk].second; i++) {
+                    const char* item = data + (i * stride);
+                    mesh.vertices[i] = Point_X<3, value_type>(readProperty(item, position[0]), readProperty(item, position[1]), readProperty(item, position[2]));
+                    if(!normal.empty()) {
+                        mesh.normals[i] = Vector_X<3, value_type>(readProperty(item, normal[0]), readProperty(item, normal[1]), readProperty(item, normal[2]));
+                    }
+                    if(!uv.empty()) {
+                        mesh.uvs[i] = Point_X<2, value_type>(readProperty(item, uv[0]), readProperty(item, uv[1]));
+                    }
+                }
+            });
+            return size;
+        }
+
+        /*!
+         * Decode the faces assuming every one is a triangle, so every face has the same size
+         * @return the size in bytes of the faces, std::nullopt if some face isn't a triangle
+         */
+        [[nodiscard]] static std::optional<size_t> readTriangles(const Element& element, size_t list, const char* data, const char* end,
+                                                const Header& header, MeshData<value_type>& mesh)
+        {
+            size_t stride = 0, list_offset = 0;
+            for(size_t i = 0; i < element.properties.size(); i++) {
+                const Property& property = element.properties[i];
+                if(i == list) {
+                    list_offset = stride;
+                    stride += sizeOf(property.count_type) + (3 * sizeOf(property.type));
+                } else if(property.is_list) {
+                    return std::nullopt;
+                } else {
+                    stride += sizeOf(property.type);
+                }
+            }
+            if(static_cast<size_t>(end - data) / stride < element.count) {
+                return std::nullopt;
+            }
+
+            const Property& indices = element.properties[list];
+            const size_t index_size = sizeOf(indices.type);
+            mesh.indices.resize(3 * element.count);
+            std::atomic<bool> all_triangles = true;
+            std::vector<std::pair<size_t, size_t>> ranges = utility::splitRange(element.count, min_chunk_size);
+            utility::parallelFor(ranges.size(), [&](size_t chunk) {
+                for(size_t i = ranges[chunk].first; i < ranges[chunk].second && all_triangles.load(std::memory_order_relaxed); i++) {
+                    const char* face = data + (i * stride) + list_offset;
+                    if(read<int64_t>(face, indices.count_type, header.swap_bytes) != 3) {
+                        all_triangles = false;
+                        return;
+                    }
+                    face += sizeOf(indices.count_type);
+                    for(size_t corner = 0; corner < 3; corner++) {
+                        mesh.indices[(3 * i) + corner] = read<uint32_t>(face + (corner * index_size), indices.type, header.swap_bytes);
+                    }
+                }
+            });
+            if(!all_triangles) {
+                return std::nullopt;
+            }
+            return stride * element.count;
+        }
+
+        /*!
+         * Decode faces of any size one at a time
+         * @return the size in bytes of the faces
+         */
+        static size_t readPolygons(const Element& element, size_t list, const char* data, const char* end,
+                                 const Header& header, MeshData<value_type>& mesh, const std::string& name)
+        {
+            mesh.indices.clear();
+            const char* begin = data;
+            std::vector<uint32_t> face;
+            for(size_t i = 0; i < element.count; i++) {
+                size_t size = itemSize(element, data, end, header.swap_bytes, name);
+                const char* property_data = data;
+                for(size_t property = 0; property < element.properties.size(); property++) {
+                    const Property& current = element.properties[property];
+                    if(!current.is_list) {
+                        property_data += sizeOf(current.type);
+                        continue;
+                    }
+                    auto count = read<size_t>(property_data, current.count_type, header.swap_bytes);
+                    property_data += sizeOf(current.count_type);
+                    if(property == list) {
+                        face.clear();
+                        for(size_t corner = 0; corner < count; corner++) {
+                            face.push_back(read<uint32_t>(property_data + (corner * sizeOf(current.type)), current.type, header.swap_bytes));
+                        }
+                        for(size_t corner = 1; corner + 1 < face.size(); corner++) {
+                            mesh.indices.insert(mesh.indices.end(), {face[0], face[corner], face[corner + 1]});
+                        }
+                    }
+                    property_data += count * sizeOf(current.type);
+                }
+                data += size;
+            }
+            return static_cast<size_t>(data - begin);
+        }
+
+    public:
+        /*!
+         * @param bytes the contents of a PLY file
+         * @param name the name of the file, used in error messages
+         * @return the mesh in the file
+         * @throws std::runtime_error if the file is malformed or isn't binary
+         */
+        [[nodiscard]] static MeshData<value_type> Parse(std::span<const char> bytes, const std::string& name)
+        {
+            Header header = parseHeader(bytes, name);
+            MeshData<value_type> mesh;
+            const char* data = bytes.data() + header.data_offset;
+            const char* end = bytes.data() + bytes.size();
+            bool has_vertices = false;
+            for(const Element& element : header.elements) {
+                if(element.name == "vertex") {
+                    data += readVertices(element, data, end, header, mesh, name);
+                    has_vertices = true;
+                } else if(element.name == "face") {
+                    std::optional<size_t> list = element.find("vertex_indices");
+                    if(!list.has_value()) {
+                        list = element.find("vertex_index");
+                    }
+                    if(!list.has_value() || !element.properties[list.value()].is_list) {
+                        throw std::runtime_error(name + ": PLY faces must have a vertex_indices list");
+                    }
+                    std::optional<size_t> size = readTriangles(element, list.value(), data, end, header, mesh);
+                    data += size.has_value() ? size.value() : readPolygons(element, list.value(), data, end, header, mesh, name);
+                } else {
+                    data += elementSize(element, data, end, header.swap_bytes, name);
+                }
+            }
+            if(!has_vertices) {
+                throw std::runtime_error(name + ": the PLY file has no vertex element");
+            }
+            return mesh;
+        }
+    };
+}
@@ -12,6 +12,8 @@
 #include "json.h"
 #include "LinearAlgebraTypeTraits.h"
 #include "LinearAlgebraJsonParser.h"
+#include "Statistics.h"
+#include "BinaryStream.h"
 
 namespace geometry
 {
@@ -25,6 +27,7 @@ namespace geometry
         using Ray_3 = Ray<3, value_type>;
         using Point_3 = Point_X<3, value_type>;
         using Vector_3 = Vector_X<3, value_type>;
+        using BoundingBox_3 = BoundingBox<3, value_type>;
 
         Point_3  m_center{};
         Vector_3 m_normal{};
@@ -52,21 +55,41 @@ namespace geometry
         }
 
         /*!
-         * Determines if the given /p ray intersects this plane and returns the intersection point.
+         * Determines if the given /p ray hits this plane closer than \p record.t, and narrows \p record.t to the hit if so.
          * @param ray The ray to check for intersection
-         * @return a std::optional containing the intersection point, if it exists. containing nothing, otherwise.
+         * @param record the closest hit found so far
+         * @return true if \p record was updated
          * @details uses the solution described here: https://www.scratchapixel.com/lessons/3d-basic-rendering/minimal-ray-tracer-rendering-simple-shapes/ray-plane-and-ray-disk-intersection
          */
-        [[nodiscard]] std::optional<Point_3> getIntersectionPoint(const Ray_3& ray) const override
+        [[nodiscard]] bool intersect(const Ray_3& ray, HitRecord<value_type>& record) const override
         {
+            utility::count(utility::Counter::PlaneTests);
             value_type denominator = m_normal * ray.getDirection();
-            static const value_type epsilon = 1e-6;
+            static constexpr auto epsilon = static_cast<value_type>(1e-6);
             if(denominator <= epsilon) {
-                return std::nullopt;
+                return false;
             }
             Vector_3 ray_origin_to_plane_center = m_center - ray.getOrigin();
             value_type t = (ray_origin_to_plane_center * m_normal) / denominator;
-            return { ray * t };
+            if(t < 0 || t >= record.t) {
+                return false;
+            }
+            record.t = t;
+            return true;
+        }
+
+        /*!
+         * Determines if the given /p ray intersects this plane and returns the intersection point.
+         * @param ray The ray to check for intersection
+         * @return a std::optional containing the intersection point, if it exists. containing nothing, otherwise.
+         */
+        [[nodiscard]] std::optional<Point_3> getIntersectionPoint(const Ray_3& ray) const override
+        {
+            HitRecord<value_type> record;
+            if(!intersect(ray, record)) {
+                return std::nullopt;
+            }
+            return {ray * record.t};
         }
 
         /*!
@@ -89,6 +112,20 @@ namespace geometry
             return m_normal;
         }
 
+        /*!
+         * An infinite plane has no finite bounds.
+         * @return std::nullopt
+         */
+        [[nodiscard]] std::optional<BoundingBox_3> getBoundingBox() const override
+        {
+            return std::nullopt;
+        }
+
+        /*!
+         * @return The plane center
+         */
+        [[nodiscard]] Point_3 getCentroid() const override { return m_center; }
+
         /*!
          * Construct a plane from the given \p json_node
          * @param json_node the json containing the parameters to construct the plane
@@ -120,6 +157,26 @@ namespace geometry
             m_color.fromJson(color_json);
         }
 
+        /*!
+         * Write the state of the plane for the scene cache. See GeometryBuilder::ToBinary
+         */
+        void writeBinary(utility::BinaryWriter& writer) const
+        {
+            writer.write(m_center);
+            writer.write(m_normal);
+            writer.write(m_color);
+        }
+
+        /*!
+         * Read back the state written by writeBinary
+         */
+        void readBinary(utility::BinaryReader& reader)
+        {
+            m_center = reader.read<Point_3>();
+            m_normal = reader.read<Vector_3>();
+            m_color = reader.read<Color>();
+        }
+
         /*!
          * @return The plane center
          */
@@ -0,0 +1,258 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "LinearAlgebraTypeTraits.h"
+#include "Ray.h"
+#include "Geometry.h"
+#include "HitRecord.h"
+#include "Sphere.h"
+#include "Plane.h"
+#include "BoundedPlane.h"
+#include "Triangle.h"
+
+namespace geometry
+{
+    /*!
+     * How an environment stores its geometry for intersection queries
+     */
+    enum class GeometryStorage
+    {
+        // every query goes through a virtual call on the shared geometry objects
+        Virtual,
+        // built in geometry is kept by value in per type arrays and dispatched on a type tag
+        Packed
+    };
+
+    /*!
+     * @param storage_name one of "virtual" or "packed"
+     * @return the corresponding GeometryStorage
+     */
+    [[nodiscard]] inline GeometryStorage GeometryStorageFromString(const std::string& storage_name)
+    {
+        if(storage_name == "virtual") {
+            return GeometryStorage::Virtual;
+        } else if(storage_name == "packed") {
+            return GeometryStorage::Packed;
+        }
+        throw std::invalid_argument("geometry storage must be one of the following values: \n [virtual, packed]. got " + storage_name);
+    }
+
+    /*!
+     * Stores copies of the built in geometry types by value, in one contiguous array per type. Each primitive keeps the
+     * id it was added with, and is found through a small type tag and index, so queries are a switch and a direct
+     * (inlinable) call rather than a pointer chase and a virtual call. Geometry types that aren't built in are kept
+     * by pointer and still dispatched virtually, so the Geometry interface stays open for extension.
+     *
+     * The arrays are never modified once built, so copies of the store share them. share hands out pointers into them,
+     * so the owner of the store can drop its own copies of the built in geometry rather than keep everything twice.
+     */
+    template<IsFloatingPoint value_type>
+    class PrimitiveStore
+    {
+    public:
+        using Geometry_Ptr = std::shared_ptr<Geometry<value_type>>;
+        using Ray_3 = Ray<3, value_type>;
+
+    private:
+        enum class Type : uint8_t
+        {
+            Sphere,
+            Plane,
+            BoundedPlane,
+            Triangle,
+            Other
+        };
+
+        struct Reference
+        {
+            Type type;
+            uint32_t index;
+        };
+
+        struct Storage
+        {
+            std::vector<Sphere<value_type>> spheres;
+            std::vector<Plane<value_type>> planes;
+            std::vector<BoundedPlane<value_type>> bounded_planes;
+            std::vector<Triangle<value_type>> triangles;
+            std::vector<Geometry_Ptr> other;
+        };
+
+        std::vector<Reference> m_references;
+        std::shared_ptr<Storage> m_storage = std::make_shared<Storage>();
+
+        template<typename Concrete>
+        [[nodiscard]] static bool isExactly(const Geometry<value_type>& geometry)
+        {
+            return typeid(geometry) == typeid(Concrete);
+        }
+
+        template<typename Concrete>
+        void addTo(std::vector<Concrete>& container, Type type, const Geometry<value_type>& geometry)
+        {
+            m_references.push_back({type, static_cast<uint32_t>(container.size())});
+            container.push_back(static_cast<const Concrete&>(geometry));
+        }
+
+        /*!
+         * Call \p function with the primitive \p id as its concrete type, or as a Geometry for types that aren't built in
+         */
+        template<typename Function>
+        decltype(auto) visit(uint32_t id, Function&& function) const
+        {
+            const Reference& reference = m_references[id];
+            switch(reference.type) {
+                case Type::Sphere:       return function(std::as_const(m_storage->spheres[reference.index]));
+                case Type::Plane:        return function(std::as_const(m_storage->planes[reference.index]));
+                case Type::BoundedPlane: return function(std::as_const(m_storage->bounded_planes[reference.index]));
+                case Type::Triangle:     return function(std::as_const(m_storage->triangles[reference.index]));
+                default:                 return function(static_cast<const Geometry<value_type>&>(*m_storage->other[reference.index]));
+            }
+        }
+
+    public:
+        PrimitiveStore() = default;
+        ~PrimitiveStore() = default;
+        PrimitiveStore(const PrimitiveStore& other) = default;
+        PrimitiveStore(PrimitiveStore&& other) noexcept = default;
+        PrimitiveStore& operator=(const PrimitiveStore& other) = default;
+        PrimitiveStore& operator=(PrimitiveStore&& other) noexcept = default;
+
+        /*!
+         * Replace the contents of the store with copies of \p geometry, or \p geometry itself for types that aren't
+         * built in. The id of each primitive is its index in
+         * \p geometry.
+         * @param geometry the geometry to store
+         */
+        void build(const std::vector<Geometry_Ptr>& geometry)
+        {
+            *this = PrimitiveStore();
+            m_references.reserve(geometry.size());
+            for(const Geometry_Ptr& item : geometry) {
+                if(isExactly<Sphere<value_type>>(*item)) {
+                    addTo(m_storage->spheres, Type::Sphere, *item);
+                } else if(isExactly<Plane<value_type>>(*item)) {
+                    addTo(m_storage->planes, Type::Plane, *item);
+                } else if(isExactly<BoundedPlane<value_type>>(*item)) {
+                    addTo(m_storage->bounded_planes, Type::BoundedPlane, *item);
+                } else if(isExactly<Triangle<value_type>>(*item)) {
+                    addTo(m_storage->triangles, Type::Triangle, *item);
+                } else {
+                    m_references.push_back({Type::Other, static_cast<uint32_t>(m_storage->other.size())});
+                    m_storage->other.push_back(item);
+                }
+            }
+        }
+
+        /*!
+         * @return the number of primitives in the store
+         */
+        [[nodiscard]] size_t size() const { return m_references.size(); }
+
+        /*!
+         * Intersect an element of a stored primitive with the \p ray, narrowing \p record.t if it is hit closer. See
+         * Geometry::intersectElement
+         * @param element the primitive id and the index of the element within it
+         */
+        [[nodiscard]] bool intersect(const ElementReference& element, const Ray_3& ray, HitRecord<value_type>& record) const
+        {
+            return visit(element.geometry, [&](const auto& primitive) {
+                using Concrete = std::decay_t<decltype(primitive)>;
+                if constexpr (std::is_same_v<Concrete, Geometry<value_type>>) {
+                    return primitive.intersectElement(element.element, ray, record);
+                } else {
+                    // a qualified call skips the virtual dispatch
+                    return primitive.Concrete::intersect(ray, record);
+                }
+            });
+        }
+
+        /*!
+         * Any hit query against an element of a stored primitive. See Geometry::occludesElement
+         * @param element the primitive id and the index of the element within it
+         */
+        [[nodiscard]] bool occludes(const ElementReference& element, const Ray_3& ray, value_type t_max) const
+        {
+            return visit(element.geometry, [&](const auto& primitive) {
+                using Concrete = std::decay_t<decltype(primitive)>;
+                if constexpr (std::is_same_v<Concrete, Geometry<value_type>>) {
+                    return primitive.occludesElement(element.element, ray, t_max);
+                } else {
+                    return primitive.Concrete::occludes(ray, t_max);
+                }
+            });
+        }
+
+        /*!
+         * Fill in the rest of a \p record of a hit on primitive \p id. See Geometry::completeHitRecord
+         */
+        void completeHitRecord(uint32_t id, const Ray_3& ray, HitRecord<value_type>& record) const
+        {
+            visit(id, [&](const auto& primitive) {
+                using Concrete = std::decay_t<decltype(primitive)>;
+                if constexpr (std::is_same_v<Concrete, Geometry<value_type>>) {
+                    primitive.completeHitRecord(ray, record);
+                } else {
+                    primitive.Concrete::completeHitRecord(ray, record);
+                }
+            });
+        }
+
+        /*!
+         * @return primitive \p id if it is stored as, or derives from, a \p Concrete. nullptr otherwise
+         */
+        template<typename Concrete>
+        [[nodiscard]] const Concrete* getAs(uint32_t id) const
+        {
+            const Reference& reference = m_references[id];
+            if constexpr (std::is_same_v<Concrete, Sphere<value_type>>) {
+                return reference.type == Type::Sphere ? &m_storage->spheres[reference.index] : nullptr;
+            } else if constexpr (std::is_same_v<Concrete, Plane<value_type>>) {
+                return reference.type == Type::Plane ? &m_storage->planes[reference.index] : nullptr;
+            } else if constexpr (std::is_same_v<Concrete, BoundedPlane<value_type>>) {
+                return reference.type == Type::BoundedPlane ? &m_storage->bounded_planes[reference.index] : nullptr;
+            } else if constexpr (std::is_same_v<Concrete, Triangle<value_type>>) {
+                return reference.type == Type::Triangle ? &m_storage->triangles[reference.index] : nullptr;
+            } else {
+                return reference.type == Type::Other ? dynamic_cast<const Concrete*>(m_storage->other[reference.index].get()) : nullptr;
+            }
+        }
+
+        /*!
+         * @return the stored primitive \p id
+         */
+        [[nodiscard]] const Geometry<value_type>* get(uint32_t id) const
+        {
+            return visit(id, [](const auto& primitive) { return static_cast<const Geometry<value_type>*>(&primitive); });
+        }
+
+        /*!
+         * @return primitive \p id as a pointer that shares ownership of the store's arrays, so it stays valid after the
+         * store is rebuilt or destroyed. For types that aren't built in, the pointer the primitive was added with
+         */
+        [[nodiscard]] Geometry_Ptr share(uint32_t id) const
+        {
+            const Reference& reference = m_references[id];
+            Storage& storage = *m_storage;
+            switch(reference.type) {
+                case Type::Sphere:       return Geometry_Ptr(m_storage, &storage.spheres[reference.index]);
+                case Type::Plane:        return Geometry_Ptr(m_storage, &storage.planes[reference.index]);
+                case Type::BoundedPlane: return Geometry_Ptr(m_storage, &storage.bounded_planes[reference.index]);
+                case Type::Triangle:     return Geometry_Ptr(m_storage, &storage.triangles[reference.index]);
+                default:                 return storage.other[reference.index];
+            }
+        }
+    };
+}
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <optional>
+#include <numbers>
 
 #include "Geometry.h"
 #include "Point_X.h"
@@ -12,6 +13,8 @@
 #include "json.h"
 #include "LinearAlgebraTypeTraits.h"
 #include "LinearAlgebraJsonParser.h"
+#include "Statistics.h"
+#include "BinaryStream.h"
 
 namespace geometry
 {
@@ -25,6 +28,7 @@ namespace geometry
         using Ray_3 = Ray<3, value_type>;
         using Point_3 = Point_X<3, value_type>;
         using Vector_3 = Vector_X<3, value_type>;
+        using BoundingBox_3 = BoundingBox<3, value_type>;
 
         Point_3 m_center;
         value_type  m_radius{};
@@ -52,37 +56,100 @@ namespace geometry
         }
 
         /*!
-         * Determines if the given /p ray intersects this sphere and returns the first intersection point.
+         * Determines if the given /p ray hits this sphere closer than \p record.t, and narrows \p record.t to the first
+         * intersection if so.
          * @param ray The ray to check for intersection
-         * @return a std::optional containing the first intersection point, if it exists. containing nothing, otherwise.
+         * @param record the closest hit found so far
+         * @return true if \p record was updated
          * @details uses the geometric solution described here: https://www.scratchapixel.com/lessons/3d-basic-rendering/minimal-ray-tracer-rendering-simple-shapes/ray-sphere-intersection
          */
-        [[nodiscard]] std::optional<Point_3> getIntersectionPoint(const Ray_3& ray) const override
+        [[nodiscard]] bool intersect(const Ray_3& ray, HitRecord<value_type>& record) const override
         {
+            utility::count(utility::Counter::SphereTests);
             Vector_3 center_to_ray_origin = m_center - ray.getOrigin();
             value_type t_projection_of_center_to_ray = center_to_ray_origin * ray.getDirection();
             if (t_projection_of_center_to_ray < 0) {
-                return std::nullopt;
+                return false;
             }
             value_type projected_center_to_center_distance_squared = (center_to_ray_origin * center_to_ray_origin) - (t_projection_of_center_to_ray * t_projection_of_center_to_ray);
             value_type radius_squared = m_radius * m_radius;
             if (projected_center_to_center_distance_squared > radius_squared)
             {
-                return std::nullopt;
+                return false;
             }
             value_type t_projected_center_to_sphere_surface = std::sqrt(radius_squared - projected_center_to_center_distance_squared);
             value_type t_first_intersection = t_projection_of_center_to_ray - t_projected_center_to_sphere_surface;
-            value_type t_second_intersection = t_projection_of_center_to_ray + t_projected_center_to_sphere_surface;
 
-            if (t_first_intersection > t_second_intersection) {
-                std::swap(t_first_intersection, t_second_intersection);
+            if (t_first_intersection < 0 || t_first_intersection >= record.t)
+            {
+                return false;  // intersection point is behind the ray, or behind something else
             }
+            record.t = t_first_intersection;
+            return true;
+        }
 
-            if (t_first_intersection < 0)
+        /*!
+         * Any hit version of intersect, which only needs the square root when the first intersection is beyond \p t_max
+         * or close to it
+         * @param ray The ray to check for intersection
+         * @param t_max the furthest ray parameter of interest
+         * @return true if the \p ray hits this sphere in [0, \p t_max)
+         */
+        [[nodiscard]] bool occludes(const Ray_3& ray, value_type t_max) const override
+        {
+            utility::count(utility::Counter::SphereTests);
+            Vector_3 center_to_ray_origin = m_center - ray.getOrigin();
+            value_type t_projection_of_center_to_ray = center_to_ray_origin * ray.getDirection();
+            if (t_projection_of_center_to_ray < 0) {
+                return false;
+            }
+            value_type projected_center_to_center_distance_squared = (center_to_ray_origin * center_to_ray_origin) - (t_projection_of_center_to_ray * t_projection_of_center_to_ray);
+            value_type radius_squared = m_radius * m_radius;
+            if (projected_center_to_center_distance_squared > radius_squared)
+            {
+                return false;
+            }
+            value_type t_projected_center_to_sphere_surface_squared = radius_squared - projected_center_to_center_distance_squared;
+            // the first intersection is behind the ray origin, i.e. the origin is inside the sphere
+            if (t_projection_of_center_to_ray * t_projection_of_center_to_ray < t_projected_center_to_sphere_surface_squared)
+            {
+                return false;
+            }
+            // the first intersection is never further than the projection of the center
+            if (t_projection_of_center_to_ray < t_max)
             {
-                return std::nullopt;  // intersection point is behind the ray
+                return true;
             }
-            return {ray * t_first_intersection};
+            return t_projection_of_center_to_ray - std::sqrt(t_projected_center_to_sphere_surface_squared) < t_max;
+        }
+
+        /*!
+         * Determines if the given /p ray intersects this sphere and returns the first intersection point.
+         * @param ray The ray to check for intersection
+         * @return a std::optional containing the first intersection point, if it exists. containing nothing, otherwise.
+         */
+        [[nodiscard]] std::optional<Point_3> getIntersectionPoint(const Ray_3& ray) const override
+        {
+            HitRecord<value_type> record;
+            if(!intersect(ray, record)) {
+                return std::nullopt;
+            }
+            return {ray * record.t};
+        }
+
+        /*!
+         * Fills in the point, normal, and the longitude/latitude of the hit, both mapped to [0, 1]
+         * @param ray the ray that was passed to intersect
+         * @param record the record of the hit on this sphere
+         */
+        void completeHitRecord(const Ray_3& ray, HitRecord<value_type>& record) const override
+        {
+            record.point = ray * record.t;
+            record.normal = getNormalAt(record.point);
+            // the normal points towards the center, so flip it to get the direction of the point from the center
+            value_type u = static_cast<value_type>(0.5) + std::atan2(-record.normal[2], -record.normal[0]) / static_cast<value_type>(2.0 * std::numbers::pi);
+            value_type v = static_cast<value_type>(0.5) - std::asin(std::clamp(-record.normal[1], static_cast<value_type>(-1), static_cast<value_type>(1))) / std::numbers::pi_v<value_type>;
+            record.uv = Point_X<2, value_type>(u, v);
         }
 
         /*!
@@ -105,6 +172,21 @@ namespace geometry
             return (m_center - point).normalize();
         }
 
+        /*!
+         * @return the box enclosing the sphere
+         */
+        [[nodiscard]] std::optional<BoundingBox_3> getBoundingBox() const override
+        {
+            Vector_3 radius_vector;
+            radius_vector.fill(m_radius);
+            return BoundingBox_3(m_center - radius_vector, m_center + radius_vector);
+        }
+
+        /*!
+         * @return The sphere center
+         */
+        [[nodiscard]] Point_3 getCentroid() const override { return m_center; }
+
         /*!
          * Construct a sphere from the given \p json_node
          * @param json_node the json containing the parameters to construct the sphere
@@ -141,6 +223,26 @@ namespace geometry
             m_color.fromJson(color_json);
         }
 
+        /*!
+         * Write the state of the sphere for the scene cache. See GeometryBuilder::ToBinary
+         */
+        void writeBinary(utility::BinaryWriter& writer) const
+        {
+            writer.write(m_center);
+            writer.write(m_radius);
+            writer.write(m_color);
+        }
+
+        /*!
+         * Read back the state written by writeBinary
+         */
+        void readBinary(utility::BinaryReader& reader)
+        {
+            m_center = reader.read<Point_3>();
+            m_radius = reader.read<value_type>();
+            m_color = reader.read<Color>();
+        }
+
         /*!
          * @return The sphere center
          */
@@ -0,0 +1,170 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "LinearAlgebraTypeTraits.h"
+#include "SimdPack.h"
+#include "Ray.h"
+#include "HitRecord.h"
+#include "Sphere.h"
+#include "AlignedAllocator.h"
+#include "Statistics.h"
+
+namespace geometry
+{
+    using namespace linear_algebra_core;
+
+    /*!
+     * Spheres stored as a structure of arrays (center x, y, z and radius squared), so one ray can be tested against a
+     * whole simd::Pack of spheres at once. The spheres of a hierarchy leaf occupy consecutive slots, so a leaf is tested
+     * a Pack at a time.
+     *
+     * The kernel performs exactly the same operations as Sphere::intersect, in the same order, so both give bit
+     * identical results.
+     */
+    template<IsFloatingPoint value_type>
+    class SphereBatch
+    {
+    public:
+        using Ray_3 = Ray<3, value_type>;
+        using Pack = simd::Pack<value_type>;
+        using Array = std::vector<value_type, utility::AlignedAllocator<value_type>>;
+
+    private:
+        // every array ends in this many NaN entries, so a full Pack can be loaded starting at any slot
+        static constexpr size_t padding = Pack::width - 1;
+
+        Array m_center_x = Array(padding, std::numeric_limits<value_type>::quiet_NaN());
+        Array m_center_y = Array(padding, std::numeric_limits<value_type>::quiet_NaN());
+        Array m_center_z = Array(padding, std::numeric_limits<value_type>::quiet_NaN());
+        Array m_radius_squared = Array(padding, std::numeric_limits<value_type>::quiet_NaN());
+        // the id each sphere was added with
+        std::vector<uint32_t> m_ids;
+
+        static void insert(Array& array, value_type value)
+        {
+            array.insert(array.end() - static_cast<std::ptrdiff_t>(padding), value);
+        }
+
+        /*!
+         * The kernel behind intersect and occluded. With \p any_hit set, returns as soon as any sphere is hit before
+         * \p record.t, without updating \p record
+         */
+        template<bool any_hit>
+        bool intersectSlots(size_t first, size_t count, const Ray_3& ray, HitRecord<value_type>& record) const
+        {
+            utility::count(utility::Counter::SphereTests, count);
+
+            const Pack origin_x = Pack::broadcast(ray.getOrigin()[0]);
+            const Pack origin_y = Pack::broadcast(ray.getOrigin()[1]);
+            const Pack origin_z = Pack::broadcast(ray.getOrigin()[2]);
+            const Pack direction_x = Pack::broadcast(ray.getDirection()[0]);
+            const Pack direction_y = Pack::broadcast(ray.getDirection()[1]);
+            const Pack direction_z = Pack::broadcast(ray.getDirection()[2]);
+            const Pack zero = Pack::broadcast(0);
+            const Pack lanes = Pack::laneIndices();
+
+            bool updated = false;
+            for(size_t offset = 0; offset < count; offset += Pack::width) {
+                size_t base = first + offset;
+                Pack to_center_x = Pack::load(&m_center_x[base]) - origin_x;
+                Pack to_center_y = Pack::load(&m_center_y[base]) - origin_y;
+                Pack to_center_z = Pack::load(&m_center_z[base]) - origin_z;
+                Pack radius_squared = Pack::load(&m_radius_squared[base]);
+
+                Pack t_projection = ((to_center_x * direction_x) + (to_center_y * direction_y)) + (to_center_z * direction_z);
+                Pack distance_squared = (((to_center_x * to_center_x) + (to_center_y * to_center_y)) + (to_center_z * to_center_z))
+                                        - (t_projection * t_projection);
+                Pack t_first = t_projection - (radius_squared - distance_squared).sqrt();
+
+                auto hit = (t_projection >= zero) & (distance_squared <= radius_squared) & (t_first >= zero) &
+                           (t_first < Pack::broadcast(record.t)) &
+                           (lanes < Pack::broadcast(static_cast<value_type>(count - offset)));
+                if(!hit.any()) {
+                    continue;
+                }
+                if constexpr (any_hit) {
+                    return true;
+                }
+
+                std::array<value_type, Pack::width> t_values;
+                t_first.store(t_values.data());
+                unsigned int hit_bits = hit.bits();
+                for(size_t lane = 0; lane < Pack::width; lane++) {
+                    if((hit_bits >> lane) & 1 && t_values[lane] < record.t) {
+                        record.t = t_values[lane];
+                        record.primitive_id = m_ids[base + lane];
+                        record.element_id = 0;
+                        updated = true;
+                    }
+                }
+            }
+            return updated;
+        }
+
+    public:
+        SphereBatch() = default;
+        ~SphereBatch() = default;
+        SphereBatch(const SphereBatch& other) = default;
+        SphereBatch(SphereBatch&& other) noexcept = default;
+        SphereBatch& operator=(const SphereBatch& other) = default;
+        SphereBatch& operator=(SphereBatch&& other) noexcept = default;
+
+        /*!
+         * Append \p sphere to the batch
+         * @param sphere the sphere to add
+         * @param id the id reported as HitRecord::primitive_id when the sphere is hit
+         */
+        void add(const Sphere<value_type>& sphere, uint32_t id)
+        {
+            Point_X<3, value_type> center = sphere.getCenter();
+            insert(m_center_x, center[0]);
+            insert(m_center_y, center[1]);
+            insert(m_center_z, center[2]);
+            insert(m_radius_squared, sphere.getRadius() * sphere.getRadius());
+            m_ids.push_back(id);
+        }
+
+        /*!
+         * @return the number of spheres in the batch
+         */
+        [[nodiscard]] size_t size() const { return m_ids.size(); }
+
+        /*!
+         * Intersect the \p ray with every sphere in the batch. See intersect(size_t, size_t, const Ray_3&, HitRecord&)
+         */
+        bool intersect(const Ray_3& ray, HitRecord<value_type>& record) const
+        {
+            return intersect(0, size(), ray, record);
+        }
+
+        /*!
+         * Intersect the \p ray with the spheres in slots [\p first, \p first + \p count). If one is hit closer than
+         * \p record.t, narrows \p record.t to the closest hit and sets \p record.primitive_id to that sphere's id. Ties
+         * go to the earliest slot, as if the spheres were tested one at a time in order.
+         * @return true if \p record was updated
+         */
+        bool intersect(size_t first, size_t count, const Ray_3& ray, HitRecord<value_type>& record) const
+        {
+            return intersectSlots<false>(first, count, ray, record);
+        }
+
+        /*!
+         * Any hit version of intersect
+         * @return true if the \p ray hits any of the spheres in slots [\p first, \p first + \p count) in [0, \p t_max)
+         */
+        [[nodiscard]] bool occluded(size_t first, size_t count, const Ray_3& ray, value_type t_max) const
+        {
+            HitRecord<value_type> record;
+            record.t = t_max;
+            return intersectSlots<true>(first, count, ray, record);
+        }
+    };
+}
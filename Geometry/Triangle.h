@@ -13,6 +13,8 @@
 #include "json.h"
 #include "LinearAlgebraTypeTraits.h"
 #include "LinearAlgebraJsonParser.h"
+#include "Statistics.h"
+#include "BinaryStream.h"
 
 namespace geometry
 {
@@ -26,16 +28,28 @@ namespace geometry
         using Ray_3 = Ray<3, value_type>;
         using Point_3 = Point_X<3, value_type>;
         using Vector_3 = Vector_X<3, value_type>;
+        using BoundingBox_3 = BoundingBox<3, value_type>;
 
         std::array<Point_3, 3> m_corners;
+        // edges from the first corner to the other two, and their cross product, kept for intersection tests
+        Vector_3 m_edge_1;
+        Vector_3 m_edge_2;
+        Vector_3 m_scaled_normal;
         Vector_3 m_normal;
         Color   m_color{};
 
-        [[nodiscard]] Vector_3 calculateNormal() const {
-            return ((m_corners[1] - m_corners[0]).cross(m_corners[2] - m_corners[0])).normalize();
+        void precompute()
+        {
+            m_edge_1 = m_corners[1] - m_corners[0];
+            m_edge_2 = m_corners[2] - m_corners[0];
+            m_scaled_normal = m_edge_1.cross(m_edge_2);
+            m_normal = Vector_3(m_scaled_normal).normalize();
         }
 
     public:
+        // rays that hit the back of the triangle, or run (almost) parallel to it, don't count as hits
+        static constexpr auto determinant_epsilon = static_cast<value_type>(1e-6);
+
         Triangle() = default;
         ~Triangle() override = default;
         Triangle(const Triangle& other) = default;
@@ -45,15 +59,17 @@ namespace geometry
 
         Triangle(const std::array<Point_3, 3>& corners, const Color& color) :
             m_corners{corners},
-            m_normal{calculateNormal()},
             m_color{color}
-        { }
+        {
+            precompute();
+        }
 
         Triangle(const Point_3& a, const Point_3& b, const Point_3& c, const Color& color) :
             m_corners{a, b, c},
-            m_normal{calculateNormal()},
             m_color{color}
-        { }
+        {
+            precompute();
+        }
 
         /*!
          * Determines if the given /p ray intersects this sphere.
@@ -67,29 +83,65 @@ namespace geometry
         }
 
         /*!
-         * Determines if the given /p ray intersects this sphere and returns the first intersection point.
+         * Determines if the given /p ray hits this triangle closer than \p record.t. If so, narrows \p record.t to the
+         * hit and stores the barycentric coordinates of the hit in \p record.uv
          * @param ray The ray to check for intersection
-         * @return a std::optional containing the first intersection point, if it exists. containing nothing, otherwise.
-         * @details uses the geometric solution described here: https://www.scratchapixel.com/lessons/3d-basic-rendering/minimal-ray-tracer-rendering-simple-shapes/ray-sphere-intersection
+         * @param record the closest hit found so far
+         * @return true if \p record was updated
          */
-        [[nodiscard]] std::optional<Point_3> getIntersectionPoint(const Ray_3& ray) const override
+        [[nodiscard]] bool intersect(const Ray_3& ray, HitRecord<value_type>& record) const override
+        {
+            utility::count(utility::Counter::TriangleTests);
+            return intersectTriangle(m_corners[0], m_edge_1, m_edge_2, m_scaled_normal, ray, record);
+        }
+
+        /*!
+         * The intersection test shared by everything made of triangles. \p record.uv is set to the weights of the second
+         * and third corners at the hit.
+         * @param corner the first corner of the triangle
+         * @param edge_1 the edge from the first corner to the second
+         * @param edge_2 the edge from the first corner to the third
+         * @param scaled_normal edge_1.cross(edge_2)
+         * @param ray The ray to check for intersection
+         * @param record the closest hit found so far
+         * @return true if \p record was updated
+         */
+        [[nodiscard]] static bool intersectTriangle(const Point_3& corner, const Vector_3& edge_1, const Vector_3& edge_2,
+                                                    const Vector_3& scaled_normal, const Ray_3& ray, HitRecord<value_type>& record)
         {
             // https://stackoverflow.com/questions/42740765/intersection-between-line-and-triangle-in-3d
-            static const value_type epsilon = 1e-6;
-            auto edge_1 = m_corners[1] - m_corners[0];
-            auto edge_2 = m_corners[2] - m_corners[0];
-            value_type determinant = -1 * (ray.getDirection() * m_normal);
-            value_type inverse_determinant = 1.0 / determinant;
-            auto A_to_Ray_Origin = ray.getOrigin() - m_corners[0];
+            // the barycentric coordinates are only correct with the un-normalized normal
+            value_type determinant = -1 * (ray.getDirection() * scaled_normal);
+            if(!(determinant >= determinant_epsilon)) {
+                return false;
+            }
+            value_type inverse_determinant = static_cast<value_type>(1.0) / determinant;
+            auto A_to_Ray_Origin = ray.getOrigin() - corner;
             auto DAO = A_to_Ray_Origin.cross(ray.getDirection());
             value_type u = edge_2 * DAO * inverse_determinant;
             value_type v = -1 * (edge_1 * DAO) * inverse_determinant;
-            value_type t = (A_to_Ray_Origin * m_normal) * inverse_determinant;
-            if(determinant >= epsilon && t >= 0.0 && u >= 0.0 && v >= 0.0 && (u + v) <= 1.0)
+            value_type t = (A_to_Ray_Origin * scaled_normal) * inverse_determinant;
+            if(t >= 0.0 && t < record.t && u >= 0.0 && v >= 0.0 && (u + v) <= 1.0)
             {
-                return ray * t;
+                record.t = t;
+                record.uv = Point_X<2, value_type>(u, v);
+                return true;
+            }
+            return false;
+        }
+
+        /*!
+         * Determines if the given /p ray intersects this triangle and returns the intersection point.
+         * @param ray The ray to check for intersection
+         * @return a std::optional containing the intersection point, if it exists. containing nothing, otherwise.
+         */
+        [[nodiscard]] std::optional<Point_3> getIntersectionPoint(const Ray_3& ray) const override
+        {
+            HitRecord<value_type> record;
+            if(!intersect(ray, record)) {
+                return std::nullopt;
             }
-            return std::nullopt;
+            return {ray * record.t};
         }
 
         /*!
@@ -106,6 +158,23 @@ namespace geometry
          */
         [[nodiscard]] Vector_3 getNormalAt(const Point_3& point) const override { return m_normal; }
 
+        /*!
+         * @return the box enclosing the three corners of the triangle
+         */
+        [[nodiscard]] std::optional<BoundingBox_3> getBoundingBox() const override
+        {
+            BoundingBox_3 result(m_corners[0], m_corners[1]);
+            return result.expand(m_corners[2]);
+        }
+
+        /*!
+         * @return the average of the three corners
+         */
+        [[nodiscard]] Point_3 getCentroid() const override
+        {
+            return m_corners[0] + (((m_corners[1] - m_corners[0]) + (m_corners[2] - m_corners[0])) / static_cast<value_type>(3));
+        }
+
         /*!
          * Construct a sphere from the given \p json_node
          * @param json_node the json containing the parameters to construct the sphere
@@ -132,14 +201,48 @@ namespace geometry
             }
 
             m_corners = {Point_3{corners[0]}, Point_3{corners[1]}, Point_3{corners[2]}};
-            m_normal = calculateNormal();
+            precompute();
             m_color.fromJson(color_json);
         }
 
+        /*!
+         * Write the state of the triangle for the scene cache. See GeometryBuilder::ToBinary
+         */
+        void writeBinary(utility::BinaryWriter& writer) const
+        {
+            for(const Point_3& corner : m_corners) {
+                writer.write(corner);
+            }
+            writer.write(m_color);
+        }
+
+        /*!
+         * Read back the state written by writeBinary
+         */
+        void readBinary(utility::BinaryReader& reader)
+        {
+            for(Point_3& corner : m_corners) {
+                corner = reader.read<Point_3>();
+            }
+            m_color = reader.read<Color>();
+            precompute();
+        }
+
         /*!
          * @return The corners of the triangle
          */
         [[nodiscard]] const std::array<Point_3, 3>& getCorners() { return m_corners; }
         [[nodiscard]] std::array<Point_3, 3> getCorners() const { return m_corners; }
+
+        /*!
+         * @return the edges from the first corner to the second and third corners
+         */
+        [[nodiscard]] const Vector_3& getFirstEdge() const  { return m_edge_1; }
+        [[nodiscard]] const Vector_3& getSecondEdge() const { return m_edge_2; }
+
+        /*!
+         * @return the cross product of the two edges, the normal scaled by twice the area of the triangle
+         */
+        [[nodiscard]] const Vector_3& getScaledNormal() const { return m_scaled_normal; }
     };
 }
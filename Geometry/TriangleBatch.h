@@ -0,0 +1,267 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "LinearAlgebraTypeTraits.h"
+#include "SimdPack.h"
+#include "Ray.h"
+#include "HitRecord.h"
+#include "Triangle.h"
+#include "AlignedAllocator.h"
+#include "Statistics.h"
+
+namespace geometry
+{
+    using namespace linear_algebra_core;
+
+    /*!
+     * Triangles stored as a structure of arrays (first corner, both edges, and their cross product), so one ray can be
+     * tested against a whole simd::Pack of triangles at once with the Möller–Trumbore algorithm. The triangles of a
+     * hierarchy leaf occupy consecutive slots, so a leaf is tested a Pack at a time.
+     *
+     * The kernel performs exactly the same operations as Triangle::intersect, in the same order, so both give bit
+     * identical results.
+     */
+    template<IsFloatingPoint value_type>
+    class TriangleBatch
+    {
+    public:
+        using Ray_3 = Ray<3, value_type>;
+        using Pack = simd::Pack<value_type>;
+        using Array = std::vector<value_type, utility::AlignedAllocator<value_type>>;
+
+    private:
+        // every array ends in this many NaN entries, so a full Pack can be loaded starting at any slot
+        static constexpr size_t padding = Pack::width - 1;
+
+        // indexed by coordinate
+        std::array<Array, 3> m_corner;
+        std::array<Array, 3> m_edge_1;
+        std::array<Array, 3> m_edge_2;
+        std::array<Array, 3> m_scaled_normal;
+        // the id each triangle was added with
+        std::vector<uint32_t> m_ids;
+
+        [[nodiscard]] std::array<Array*, 12> arrays()
+        {
+            return {&m_corner[0], &m_corner[1], &m_corner[2], &m_edge_1[0], &m_edge_1[1], &m_edge_1[2],
+                    &m_edge_2[0], &m_edge_2[1], &m_edge_2[2], &m_scaled_normal[0], &m_scaled_normal[1], &m_scaled_normal[2]};
+        }
+
+        template<typename Coordinates>
+        static void insert(std::array<Array, 3>& arrays, const Coordinates& values)
+        {
+            for(size_t i = 0; i < 3; i++) {
+                arrays[i].insert(arrays[i].end() - static_cast<std::ptrdiff_t>(padding), values[i]);
+            }
+        }
+
+        /*!
+         * The kernel behind intersect and occluded. With \p any_hit set, returns as soon as any triangle is hit before
+         * \p record.t, without updating \p record
+         */
+        template<bool any_hit>
+        bool intersectSlots(size_t first, size_t count, const Ray_3& ray, HitRecord<value_type>& record) const
+        {
+            utility::count(utility::Counter::TriangleTests, count);
+
+            const RayLanes ray_lanes(ray);
+            bool updated = false;
+            for(size_t offset = 0; offset < count; offset += Pack::width) {
+                size_t base = first + offset;
+                std::array<Pack, 3> scaled_normal = load(m_scaled_normal, base);
+                Pack determinant;
+                Mask front_facing = getFrontFacing(ray_lanes, scaled_normal, count - offset, determinant);
+                if(!front_facing.any()) {
+                    continue;
+                }
+
+                Pack t, u, v;
+                Mask hit = getHits(ray_lanes, record.t, front_facing, determinant, load(m_corner, base), load(m_edge_1, base),
+                                   load(m_edge_2, base), scaled_normal, t, u, v);
+                if(!hit.any()) {
+                    continue;
+                }
+                if constexpr (any_hit) {
+                    return true;
+                }
+                updated = recordClosest(hit, t, u, v, [&](size_t lane) { return ElementReference{m_ids[base + lane], 0}; }, record) || updated;
+            }
+            return updated;
+        }
+
+        [[nodiscard]] static std::array<Pack, 3> load(const std::array<Array, 3>& arrays, size_t slot)
+        {
+            return {Pack::load(&arrays[0][slot]), Pack::load(&arrays[1][slot]), Pack::load(&arrays[2][slot])};
+        }
+
+    public:
+        using Mask = typename Pack::Mask;
+
+        /*!
+         * A ray broadcast to every lane
+         */
+        struct RayLanes
+        {
+            std::array<Pack, 3> origin;
+            std::array<Pack, 3> direction;
+
+            explicit RayLanes(const Ray_3& ray)
+            {
+                for(size_t i = 0; i < 3; i++) {
+                    origin[i] = Pack::broadcast(ray.getOrigin()[i]);
+                    direction[i] = Pack::broadcast(ray.getDirection()[i]);
+                }
+            }
+        };
+
+        /*!
+         * First half of the Möller–Trumbore kernel, so back facing and parallel triangles are rejected before doing any
+         * more work. Shared with TriangleMesh, which gathers its triangles from the vertex buffer instead.
+         * @param ray the ray in every lane
+         * @param scaled_normal the cross product of the two edges of the triangle in each lane
+         * @param lane_count lanes at or beyond this are never front facing
+         * @param determinant set to the determinant of each lane
+         * @return the lanes that are front facing
+         */
+        [[nodiscard]] static Mask getFrontFacing(const RayLanes& ray, const std::array<Pack, 3>& scaled_normal, size_t lane_count,
+                                                 Pack& determinant)
+        {
+            determinant = Pack::broadcast(-1) * (((ray.direction[0] * scaled_normal[0]) + (ray.direction[1] * scaled_normal[1])) +
+                                                 (ray.direction[2] * scaled_normal[2]));
+            return (determinant >= Pack::broadcast(Triangle<value_type>::determinant_epsilon)) &
+                   (Pack::laneIndices() < Pack::broadcast(static_cast<value_type>(lane_count)));
+        }
+
+        /*!
+         * Second half of the Möller–Trumbore kernel
+         * @param ray the ray in every lane
+         * @param t_max only hits closer than this count
+         * @param front_facing and \p determinant as given by getFrontFacing
+         * @param corner the first corner of the triangle in each lane. \p edge_1, \p edge_2 and \p scaled_normal are
+         *               as in Triangle::intersectTriangle
+         * @param t set to the ray parameter of the hit in each lane. \p u and \p v are set to the weights of the second
+         *          and third corners
+         * @return the lanes whose triangle is hit in [0, \p t_max)
+         */
+        [[nodiscard]] static Mask getHits(const RayLanes& ray, value_type t_max, const Mask& front_facing, const Pack& determinant,
+                                          const std::array<Pack, 3>& corner, const std::array<Pack, 3>& edge_1,
+                                          const std::array<Pack, 3>& edge_2, const std::array<Pack, 3>& scaled_normal,
+                                          Pack& t, Pack& u, Pack& v)
+        {
+            const Pack zero = Pack::broadcast(0);
+            const Pack one = Pack::broadcast(1);
+            Pack inverse_determinant = one / determinant;
+
+            Pack to_origin_x = ray.origin[0] - corner[0];
+            Pack to_origin_y = ray.origin[1] - corner[1];
+            Pack to_origin_z = ray.origin[2] - corner[2];
+            Pack DAO_x = (to_origin_y * ray.direction[2]) - (to_origin_z * ray.direction[1]);
+            Pack DAO_y = (to_origin_z * ray.direction[0]) - (to_origin_x * ray.direction[2]);
+            Pack DAO_z = (to_origin_x * ray.direction[1]) - (to_origin_y * ray.direction[0]);
+
+            u = (((edge_2[0] * DAO_x) + (edge_2[1] * DAO_y)) + (edge_2[2] * DAO_z)) * inverse_determinant;
+            v = (Pack::broadcast(-1) * (((edge_1[0] * DAO_x) + (edge_1[1] * DAO_y)) + (edge_1[2] * DAO_z))) * inverse_determinant;
+            t = (((to_origin_x * scaled_normal[0]) + (to_origin_y * scaled_normal[1])) + (to_origin_z * scaled_normal[2])) *
+                inverse_determinant;
+            return front_facing & (t >= zero) & (t < Pack::broadcast(t_max)) & (u >= zero) & (v >= zero) & ((u + v) <= one);
+        }
+
+        /*!
+         * Narrow \p record to the closest of the \p hit lanes, earlier lanes winning ties
+         * @param reference called with a lane, gives the primitive id and element to report for it
+         * @return true if \p record was updated
+         */
+        template<typename LaneReference>
+        static bool recordClosest(const Mask& hit, const Pack& t, const Pack& u, const Pack& v, LaneReference&& reference,
+                                  HitRecord<value_type>& record)
+        {
+            std::array<value_type, Pack::width> t_values, u_values, v_values;
+            t.store(t_values.data());
+            u.store(u_values.data());
+            v.store(v_values.data());
+            unsigned int hit_bits = hit.bits();
+            bool updated = false;
+            for(size_t lane = 0; lane < Pack::width; lane++) {
+                if((hit_bits >> lane) & 1 && t_values[lane] < record.t) {
+                    ElementReference element = reference(lane);
+                    record.t = t_values[lane];
+                    record.uv = Point_X<2, value_type>(u_values[lane], v_values[lane]);
+                    record.primitive_id = element.geometry;
+                    record.element_id = element.element;
+                    updated = true;
+                }
+            }
+            return updated;
+        }
+
+        TriangleBatch()
+        {
+            for(Array* array : arrays()) {
+                array->assign(padding, std::numeric_limits<value_type>::quiet_NaN());
+            }
+        }
+        ~TriangleBatch() = default;
+        TriangleBatch(const TriangleBatch& other) = default;
+        TriangleBatch(TriangleBatch&& other) noexcept = default;
+        TriangleBatch& operator=(const TriangleBatch& other) = default;
+        TriangleBatch& operator=(TriangleBatch&& other) noexcept = default;
+
+        /*!
+         * Append \p triangle to the batch
+         * @param triangle the triangle to add
+         * @param id the id reported as HitRecord::primitive_id when the triangle is hit
+         */
+        void add(const Triangle<value_type>& triangle, uint32_t id)
+        {
+            insert(m_corner, triangle.getCorners()[0]);
+            insert(m_edge_1, triangle.getFirstEdge());
+            insert(m_edge_2, triangle.getSecondEdge());
+            insert(m_scaled_normal, triangle.getScaledNormal());
+            m_ids.push_back(id);
+        }
+
+        /*!
+         * @return the number of triangles in the batch
+         */
+        [[nodiscard]] size_t size() const { return m_ids.size(); }
+
+        /*!
+         * Intersect the \p ray with every triangle in the batch. See intersect(size_t, size_t, const Ray_3&, HitRecord&)
+         */
+        bool intersect(const Ray_3& ray, HitRecord<value_type>& record) const
+        {
+            return intersect(0, size(), ray, record);
+        }
+
+        /*!
+         * Intersect the \p ray with the triangles in slots [\p first, \p first + \p count). If one is hit closer than
+         * \p record.t, narrows \p record.t to the closest hit, and sets \p record.primitive_id and \p record.element_id to
+         * those the triangle was added with and \p record.uv to the barycentric coordinates of the hit. Ties go to the
+         * earliest slot, as if the triangles were tested one at a time in order.
+         * @return true if \p record was updated
+         */
+        bool intersect(size_t first, size_t count, const Ray_3& ray, HitRecord<value_type>& record) const
+        {
+            return intersectSlots<false>(first, count, ray, record);
+        }
+
+        /*!
+         * Any hit version of intersect
+         * @return true if the \p ray hits any of the triangles in slots [\p first, \p first + \p count) in [0, \p t_max)
+         */
+        [[nodiscard]] bool occluded(size_t first, size_t count, const Ray_3& ray, value_type t_max) const
+        {
+            HitRecord<value_type> record;
+            record.t = t_max;
+            return intersectSlots<true>(first, count, ray, record);
+        }
+    };
+}
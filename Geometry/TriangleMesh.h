@@ -0,0 +1,501 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Geometry.h"
+#include "Triangle.h"
+#include "TriangleBatch.h"
+#include "Point_X.h"
+#include "Vector_X.h"
+#include "Color.h"
+#include "json.h"
+#include "LinearAlgebraTypeTraits.h"
+#include "LinearAlgebraJsonParser.h"
+#include "Statistics.h"
+#include "BinaryStream.h"
+
+namespace geometry
+{
+    using namespace linear_algebra_core;
+    using namespace color_core;
+
+    /*!
+     * A mesh of triangles sharing one vertex buffer. Each triangle is three 32 bit indices into the vertices, so a
+     * vertex shared by several triangles is only stored once. Normals and uvs can optionally be given per vertex, and
+     * are interpolated across each triangle.
+     *
+     * Every triangle is an element of the mesh (see Geometry::getElementCount), so acceleration structures index the
+     * triangles individually rather than the mesh as a whole.
+     */
+    template<IsFloatingPoint value_type>
+    class TriangleMesh : public Geometry<value_type>
+    {
+    public:
+        using Ray_3 = Ray<3, value_type>;
+        using Point_2 = Point_X<2, value_type>;
+        using Point_3 = Point_X<3, value_type>;
+        using Vector_3 = Vector_X<3, value_type>;
+        using BoundingBox_3 = BoundingBox<3, value_type>;
+
+    private:
+        std::vector<Point_3> m_vertices;
+        // three per triangle
+        std::vector<uint32_t> m_indices;
+        // either empty, or one per vertex
+        std::vector<Vector_3> m_normals;
+        std::vector<Point_2> m_uvs;
+        BoundingBox_3 m_bounds;
+        Color m_color{};
+
+        [[nodiscard]] const Point_3& corner(uint32_t element, size_t corner_index) const
+        {
+            return m_vertices[m_indices[(3 * static_cast<size_t>(element)) + corner_index]];
+        }
+
+        /*!
+         * Check that every index refers to a vertex and the per vertex attributes match the vertices, then compute the
+         * bounds of the mesh
+         */
+        void validate()
+        {
+            if(m_indices.size() % 3 != 0) {
+                throw std::invalid_argument("triangle mesh indices must come in groups of three");
+            }
+            for(uint32_t index : m_indices) {
+                if(index >= m_vertices.size()) {
+                    throw std::invalid_argument("triangle mesh index " + std::to_string(index) + " is out of range for " +
+                                                std::to_string(m_vertices.size()) + " vertices");
+                }
+            }
+            if(!m_normals.empty() && m_normals.size() != m_vertices.size()) {
+                throw std::invalid_argument("a triangle mesh must have either no normals or one normal per vertex");
+            }
+            if(!m_uvs.empty() && m_uvs.size() != m_vertices.size()) {
+                throw std::invalid_argument("a triangle mesh must have either no uvs or one uv per vertex");
+            }
+            if(m_indices.size() / 3 > std::numeric_limits<uint32_t>::max()) {
+                throw std::invalid_argument("a triangle mesh can have at most 2^32 - 1 triangles");
+            }
+            m_bounds = BoundingBox_3();
+            for(uint32_t index : m_indices) {
+                m_bounds.expand(m_vertices[index]);
+            }
+        }
+
+        /*!
+         * The kernel behind intersectElements and occludesElements. The corners of a simd::Pack of triangles are
+         * gathered from the vertex buffer, and the edges and scaled normal computed from them, with the same operations
+         * as intersectElement.
+         */
+        template<bool any_hit>
+        bool intersectGathered(const ElementReference* elements, size_t count, const Ray_3& ray, HitRecord<value_type>& record) const
+        {
+            using Batch = TriangleBatch<value_type>;
+            using Pack = typename Batch::Pack;
+            using Lanes = std::array<value_type, Pack::width>;
+            utility::count(utility::Counter::TriangleTests, count);
+
+            const typename Batch::RayLanes ray_lanes(ray);
+            bool updated = false;
+            for(size_t offset = 0; offset < count; offset += Pack::width) {
+                size_t lane_count = std::min(Pack::width, count - offset);
+                // unused lanes are NaN, which never pass a test
+                std::array<std::array<Lanes, 3>, 3> corners;
+                for(std::array<Lanes, 3>& coordinates : corners) {
+                    for(Lanes& lanes : coordinates) {
+                        lanes.fill(std::numeric_limits<value_type>::quiet_NaN());
+                    }
+                }
+                for(size_t lane = 0; lane < lane_count; lane++) {
+                    for(size_t corner_index = 0; corner_index < 3; corner_index++) {
+                        const Point_3& vertex = corner(elements[offset + lane].element, corner_index);
+                        for(size_t i = 0; i < 3; i++) {
+                            corners[corner_index][i][lane] = vertex[i];
+                        }
+                    }
+                }
+
+                std::array<Pack, 3> first, edge_1, edge_2, scaled_normal;
+                for(size_t i = 0; i < 3; i++) {
+                    first[i] = Pack::load(corners[0][i].data());
+                    edge_1[i] = Pack::load(corners[1][i].data()) - first[i];
+                    edge_2[i] = Pack::load(corners[2][i].data()) - first[i];
+                }
+                // as in Vector_X::cross
+                scaled_normal[0] = (edge_1[1] * edge_2[2]) - (edge_1[2] * edge_2[1]);
+                scaled_normal[1] = (edge_1[2] * edge_2[0]) - (edge_1[0] * edge_2[2]);
+                scaled_normal[2] = (edge_1[0] * edge_2[1]) - (edge_1[1] * edge_2[0]);
+
+                Pack determinant;
+                typename Batch::Mask front_facing = Batch::getFrontFacing(ray_lanes, scaled_normal, lane_count, determinant);
+                if(!front_facing.any()) {
+                    continue;
+                }
+                Pack t, u, v;
+                typename Batch::Mask hit = Batch::getHits(ray_lanes, record.t, front_facing, determinant, first, edge_1, edge_2,
+                                                          scaled_normal, t, u, v);
+                if(!hit.any()) {
+                    continue;
+                }
+                if constexpr (any_hit) {
+                    return true;
+                }
+                updated = Batch::recordClosest(hit, t, u, v, [&](size_t lane) { return elements[offset + lane]; }, record) || updated;
+            }
+            return updated;
+        }
+
+    public:
+        TriangleMesh() = default;
+        ~TriangleMesh() override = default;
+        TriangleMesh(const TriangleMesh& other) = default;
+        TriangleMesh(TriangleMesh&& other) noexcept = default;
+        TriangleMesh& operator=(const TriangleMesh& other) = default;
+        TriangleMesh& operator=(TriangleMesh&& other) noexcept = default;
+
+        /*!
+         * @param vertices the vertex buffer
+         * @param indices three indices into \p vertices per triangle, counter clockwise when seen from the front
+         * @param color the color of the whole mesh
+         * @param normals optional per vertex normals
+         * @param uvs optional per vertex texture coordinates
+         */
+        TriangleMesh(std::vector<Point_3> vertices, std::vector<uint32_t> indices, const Color& color,
+                     std::vector<Vector_3> normals = {}, std::vector<Point_2> uvs = {}) :
+            m_vertices(std::move(vertices)),
+            m_indices(std::move(indices)),
+            m_normals(std::move(normals)),
+            m_uvs(std::move(uvs)),
+            m_color(color)
+        {
+            validate();
+        }
+
+        /*!
+         * Determines if the given /p ray intersects any triangle of the mesh.
+         * @param ray The ray to check for intersection
+         * @return true if /p ray intersects this mesh. False otherwise
+         */
+        [[nodiscard]] bool intersects(const Ray_3& ray) const override
+        {
+            return getIntersectionPoint(ray).has_value();
+        }
+
+        /*!
+         * Tests every triangle of the mesh. Acceleration structures should test the triangles through intersectElement
+         * instead.
+         * @param ray The ray to check for intersection
+         * @param record the closest hit found so far
+         * @return true if \p record was updated, in which case \p record.element_id is the triangle that was hit
+         */
+        [[nodiscard]] bool intersect(const Ray_3& ray, HitRecord<value_type>& record) const override
+        {
+            if(!m_bounds.getEntryDistance(ray.getOrigin(), ray.getInverse(), 0, record.t).has_value()) {
+                return false;
+            }
+            bool hit = false;
+            for(uint32_t element = 0; element < getElementCount(); element++) {
+                if(intersectElement(element, ray, record)) {
+                    record.element_id = element;
+                    hit = true;
+                }
+            }
+            return hit;
+        }
+
+        /*!
+         * Tests the triangles of the mesh until one of them is hit before \p t_max
+         * @return true if the \p ray hits the mesh in [0, \p t_max)
+         */
+        [[nodiscard]] bool occludes(const Ray_3& ray, value_type t_max) const override
+        {
+            if(!m_bounds.getEntryDistance(ray.getOrigin(), ray.getInverse(), 0, t_max).has_value()) {
+                return false;
+            }
+            for(uint32_t element = 0; element < getElementCount(); element++) {
+                if(occludesElement(element, ray, t_max)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /*!
+         * @return true if the \p ray hits triangle \p element in [0, \p t_max)
+         */
+        [[nodiscard]] bool occludesElement(uint32_t element, const Ray_3& ray, value_type t_max) const override
+        {
+            HitRecord<value_type> record;
+            record.t = t_max;
+            return intersectElement(element, ray, record);
+        }
+
+        /*!
+         * Determines if the given /p ray hits triangle \p element closer than \p record.t. If so, narrows \p record.t to
+         * the hit and stores the barycentric coordinates of the hit in \p record.uv
+         */
+        [[nodiscard]] bool intersectElement(uint32_t element, const Ray_3& ray, HitRecord<value_type>& record) const override
+        {
+            utility::count(utility::Counter::TriangleTests);
+            const Point_3& first = corner(element, 0);
+            Vector_3 edge_1 = corner(element, 1) - first;
+            Vector_3 edge_2 = corner(element, 2) - first;
+            return Triangle<value_type>::intersectTriangle(first, edge_1, edge_2, edge_1.cross(edge_2), ray, record);
+        }
+
+        /*!
+         * Intersect the \p ray with the triangles of \p elements a simd::Pack at a time, e.g. the slots of a hierarchy leaf.
+         * Gives the same hits as calling intersectElement on each of them in order, with ties going to the earliest.
+         * @param elements \p count references to triangles of this mesh. Their geometry is reported as
+         *                 \p record.primitive_id
+         * @param record narrowed to the closest hit, with its element_id and uv set, if a triangle is hit before
+         *               \p record.t
+         * @return true if \p record was updated
+         */
+        bool intersectElements(const ElementReference* elements, size_t count, const Ray_3& ray, HitRecord<value_type>& record) const
+        {
+            return intersectGathered<false>(elements, count, ray, record);
+        }
+
+        /*!
+         * Any hit version of intersectElements
+         * @return true if the \p ray hits any of the triangles of \p elements in [0, \p t_max)
+         */
+        [[nodiscard]] bool occludesElements(const ElementReference* elements, size_t count, const Ray_3& ray, value_type t_max) const
+        {
+            HitRecord<value_type> record;
+            record.t = t_max;
+            return intersectGathered<true>(elements, count, ray, record);
+        }
+
+        /*!
+         * Determines if the given /p ray intersects this mesh and returns the closest intersection point.
+         * @param ray The ray to check for intersection
+         * @return a std::optional containing the intersection point, if it exists. containing nothing, otherwise.
+         */
+        [[nodiscard]] std::optional<Point_3> getIntersectionPoint(const Ray_3& ray) const override
+        {
+            HitRecord<value_type> record;
+            if(!intersect(ray, record)) {
+                return std::nullopt;
+            }
+            return {ray * record.t};
+        }
+
+        /*!
+         * @param point The point to get the color at
+         * @return The color of the mesh
+         */
+        [[nodiscard]] Color getColorAt(const Point_3& point) const override { return m_color; }
+
+        /*!
+         * Retrieves the normal at the given \p point on the mesh, which means first finding the triangle it lies on.
+         * That takes a pass over every triangle, so prefer completeHitRecord, which already knows the triangle.
+         * @param point The point to get the normal at
+         * @return The normal of the triangle whose plane passes closest to \p point, among the triangles \p point lies in
+         */
+        [[nodiscard]] Vector_3 getNormalAt(const Point_3& point) const override
+        {
+            static constexpr auto tolerance = static_cast<value_type>(1e-4);
+            std::optional<uint32_t> closest;
+            Point_2 closest_weights;
+            value_type closest_distance = std::numeric_limits<value_type>::max();
+            for(uint32_t element = 0; element < getElementCount(); element++) {
+                const Point_3& first = corner(element, 0);
+                Vector_3 edge_1 = corner(element, 1) - first;
+                Vector_3 edge_2 = corner(element, 2) - first;
+                Vector_3 to_point = point - first;
+                value_type d11 = edge_1 * edge_1, d12 = edge_1 * edge_2, d22 = edge_2 * edge_2;
+                value_type dp1 = to_point * edge_1, dp2 = to_point * edge_2;
+                value_type denominator = (d11 * d22) - (d12 * d12);
+                if(denominator == 0) {
+                    continue;
+                }
+                value_type u = ((d22 * dp1) - (d12 * dp2)) / denominator;
+                value_type v = ((d11 * dp2) - (d12 * dp1)) / denominator;
+                if(u < -tolerance || v < -tolerance || u + v > 1 + tolerance) {
+                    continue;
+                }
+                value_type distance = std::abs(to_point * Vector_3(edge_1.cross(edge_2)).normalize());
+                if(distance < closest_distance) {
+                    closest_distance = distance;
+                    closest = element;
+                    closest_weights = Point_2(u, v);
+                }
+            }
+            if(!closest.has_value()) {
+                return getElementCount() > 0 ? getShadingNormal(0, Point_2()) : Vector_3(static_cast<value_type>(0), static_cast<value_type>(0), static_cast<value_type>(1));
+            }
+            return getShadingNormal(closest.value(), closest_weights);
+        }
+
+        /*!
+         * @param element the triangle
+         * @param weights the weights of the second and third corners, as stored in HitRecord::uv by intersectElement
+         * @return the interpolated vertex normal if the mesh has normals, the normal of the triangle otherwise
+         */
+        [[nodiscard]] Vector_3 getShadingNormal(uint32_t element, const Point_2& weights) const
+        {
+            if(m_normals.empty()) {
+                return Vector_3((corner(element, 1) - corner(element, 0)).cross(corner(element, 2) - corner(element, 0))).normalize();
+            }
+            size_t base = 3 * static_cast<size_t>(element);
+            value_type first_weight = 1 - weights[0] - weights[1];
+            Vector_3 normal = (m_normals[m_indices[base]] * first_weight) + (m_normals[m_indices[base + 1]] * weights[0]) +
+                              (m_normals[m_indices[base + 2]] * weights[1]);
+            return normal.normalize();
+        }
+
+        /*!
+         * Fill in the point and normal of a hit on triangle \p record.element_id. If the mesh has uvs, \p record.uv is
+         * replaced by the interpolated uvs of the hit, otherwise it keeps the barycentric coordinates.
+         */
+        void completeHitRecord(const Ray_3& ray, HitRecord<value_type>& record) const override
+        {
+            record.point = ray * record.t;
+            record.normal = getShadingNormal(record.element_id, record.uv);
+            if(!m_uvs.empty()) {
+                size_t base = 3 * static_cast<size_t>(record.element_id);
+                value_type first_weight = 1 - record.uv[0] - record.uv[1];
+                Point_2 result;
+                for(size_t i = 0; i < 2; i++) {
+                    result[i] = (m_uvs[m_indices[base]][i] * first_weight) + (m_uvs[m_indices[base + 1]][i] * record.uv[0]) +
+                                (m_uvs[m_indices[base + 2]][i] * record.uv[1]);
+                }
+                record.uv = result;
+            }
+        }
+
+        /*!
+         * @return the box enclosing every triangle of the mesh
+         */
+        [[nodiscard]] std::optional<BoundingBox_3> getBoundingBox() const override { return m_bounds; }
+
+        /*!
+         * @return the center of the bounding box of the mesh
+         */
+        [[nodiscard]] Point_3 getCentroid() const override { return m_bounds.getCenter(); }
+
+        [[nodiscard]] uint32_t getElementCount() const override { return static_cast<uint32_t>(m_indices.size() / 3); }
+
+        /*!
+         * @return the box enclosing the three corners of triangle \p element
+         */
+        [[nodiscard]] std::optional<BoundingBox_3> getElementBoundingBox(uint32_t element) const override
+        {
+            BoundingBox_3 result(corner(element, 0), corner(element, 1));
+            return result.expand(corner(element, 2));
+        }
+
+        /*!
+         * @return the average of the three corners of triangle \p element
+         */
+        [[nodiscard]] Point_3 getElementCentroid(uint32_t element) const override
+        {
+            const Point_3& first = corner(element, 0);
+            return first + (((corner(element, 1) - first) + (corner(element, 2) - first)) / static_cast<value_type>(3));
+        }
+
+        [[nodiscard]] const std::vector<Point_3>& getVertices() const { return m_vertices; }
+        [[nodiscard]] const std::vector<uint32_t>& getIndices() const { return m_indices; }
+        [[nodiscard]] const std::vector<Vector_3>& getNormals() const { return m_normals; }
+        [[nodiscard]] const std::vector<Point_2>& getUvs() const { return m_uvs; }
+
+        /*!
+         * Construct a triangle mesh from the given \p json_node, i.e.
+         * { "vertices": [[X, Y, Z], ...], "triangles": [[A, B, C], ...], "color": [R, G, B] }, optionally with
+         * "normals": [[X, Y, Z], ...] and "uvs": [[U, V], ...], one per vertex
+         * @param json_node the json containing the parameters to construct the mesh
+         */
+        void fromJson(const nlohmann::json& json_node) override
+        {
+            std::vector<std::array<value_type, 3>> vertices, normals;
+            std::vector<std::array<value_type, 2>> uvs;
+            std::vector<std::array<uint32_t, 3>> triangles;
+            nlohmann::json color_json;
+
+            try {
+                vertices = json_node.at("vertices").get<decltype(vertices)>();
+            } catch(std::exception& e) {
+                throw std::invalid_argument("'vertices' field must be specified in the form: [ [X, Y, Z], ... ]");
+            }
+            try {
+                triangles = json_node.at("triangles").get<decltype(triangles)>();
+            } catch(std::exception& e) {
+                throw std::invalid_argument("'triangles' field must be specified in the form: [ [A, B, C], ... ]");
+            }
+            try {
+                if(json_node.contains("normals")) {
+                    normals = json_node.at("normals").get<decltype(normals)>();
+                }
+                if(json_node.contains("uvs")) {
+                    uvs = json_node.at("uvs").get<decltype(uvs)>();
+                }
+            } catch(std::exception& e) {
+                throw std::invalid_argument("'normals' and 'uvs' fields must be specified in the form: [ [X, Y, Z], ... ] and [ [U, V], ... ]");
+            }
+            try {
+                color_json = json_node.at("color");
+            } catch(std::exception& e) {
+                throw std::invalid_argument("Could not find the required 'color' key.");
+            }
+
+            m_vertices.clear();
+            m_normals.clear();
+            m_uvs.clear();
+            for(const std::array<value_type, 3>& vertex : vertices) {
+                m_vertices.emplace_back(vertex);
+            }
+            for(const std::array<value_type, 3>& normal : normals) {
+                m_normals.emplace_back(normal);
+            }
+            for(const std::array<value_type, 2>& uv : uvs) {
+                m_uvs.emplace_back(uv);
+            }
+            m_indices.clear();
+            m_indices.reserve(3 * triangles.size());
+            for(const std::array<uint32_t, 3>& triangle : triangles) {
+                m_indices.insert(m_indices.end(), triangle.begin(), triangle.end());
+            }
+            m_color.fromJson(color_json);
+            validate();
+        }
+
+        /*!
+         * Write the state of the mesh for the scene cache. See GeometryBuilder::ToBinary
+         */
+        void writeBinary(utility::BinaryWriter& writer) const
+        {
+            writer.writeVector<Point_3>(m_vertices);
+            writer.writeVector<uint32_t>(m_indices);
+            writer.writeVector<Vector_3>(m_normals);
+            writer.writeVector<Point_2>(m_uvs);
+            writer.write(m_color);
+        }
+
+        /*!
+         * Read back the state written by writeBinary
+         */
+        void readBinary(utility::BinaryReader& reader)
+        {
+            m_vertices = reader.readVector<Point_3>();
+            m_indices = reader.readVector<uint32_t>();
+            m_normals = reader.readVector<Vector_3>();
+            m_uvs = reader.readVector<Point_2>();
+            m_color = reader.read<Color>();
+            validate();
+        }
+    };
+}
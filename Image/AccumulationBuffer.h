@@ -0,0 +1,136 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Color.h"
+#include "Image.h"
+#include "AlignedAllocator.h"
+
+namespace output
+{
+    using namespace color_core;
+
+    /*!
+     * Running per pixel sums of samples as single precision RGBA, along with the number of samples in each pixel. Every
+     * channel is its own plane, with rows padded out to a whole number of cache lines like Image, so a pass over the
+     * buffer can load a full simd::Pack<float> at any multiple of the pack width in a row.
+     *
+     * Samples can be added a few at a time, e.g. one per progressive pass. Nothing is clamped or converted to integers
+     * here; ToneMapper turns the buffer into an Image once the samples are in.
+     */
+    class AccumulationBuffer
+    {
+    public:
+        using Plane = std::vector<float, utility::AlignedAllocator<float, Image::alignment>>;
+
+        /*!
+         * The planes of one row
+         */
+        struct Row
+        {
+            const float* red;
+            const float* green;
+            const float* blue;
+            const float* alpha;
+            // the number of samples summed up in each pixel
+            const float* samples;
+        };
+
+    private:
+        static constexpr size_t floats_per_line = Image::alignment / sizeof(float);
+
+        Plane m_red;
+        Plane m_green;
+        Plane m_blue;
+        Plane m_alpha;
+        Plane m_samples;
+        size_t m_width = 0;
+        size_t m_height = 0;
+        size_t m_stride = 0;
+
+    public:
+        AccumulationBuffer() = default;
+        ~AccumulationBuffer() = default;
+        AccumulationBuffer(const AccumulationBuffer& other) = default;
+        AccumulationBuffer(AccumulationBuffer&& other) noexcept = default;
+        AccumulationBuffer& operator=(const AccumulationBuffer& other) = default;
+        AccumulationBuffer& operator=(AccumulationBuffer&& other) noexcept = default;
+
+        /*!
+         * Construct an empty buffer, with no samples in any pixel
+         * @param width width of the buffer
+         * @param height height of the buffer
+         */
+        AccumulationBuffer(size_t width, size_t height)
+            : m_width(width), m_height(height), m_stride(((width + floats_per_line - 1) / floats_per_line) * floats_per_line)
+        {
+            for(Plane* plane : {&m_red, &m_green, &m_blue, &m_alpha, &m_samples}) {
+                plane->assign(m_stride * m_height, 0.0f);
+            }
+        }
+
+        /*!
+         * Add samples to the pixel at \p x, \p y. Unchecked, for the render loops.
+         * @param x X coordinate. Must be less than width()
+         * @param y Y coordinate. Must be less than height()
+         * @param sum the sum of the colors of the samples. Its alpha is taken as the samples' average alpha
+         * @param samples the number of samples in \p sum
+         */
+        inline void add(size_t x, size_t y, const Color& sum, uint32_t samples)
+        {
+            size_t index = (y * m_stride) + x;
+            const std::array<double, 4>& rgba = sum.rgba();
+            auto sample_count = static_cast<float>(samples);
+            m_red[index] += static_cast<float>(rgba[0]);
+            m_green[index] += static_cast<float>(rgba[1]);
+            m_blue[index] += static_cast<float>(rgba[2]);
+            m_alpha[index] += static_cast<float>(rgba[3]) * sample_count;
+            m_samples[index] += sample_count;
+        }
+
+        /*!
+         * @return the number of samples added to the pixel at \p x, \p y
+         */
+        [[nodiscard]] inline uint32_t getSampleCount(size_t x, size_t y) const
+        {
+            return static_cast<uint32_t>(m_samples[(y * m_stride) + x]);
+        }
+
+        /*!
+         * @param y index of the row. Must be less than height()
+         * @return the planes of row \p y, each getStride() floats long
+         */
+        [[nodiscard]] inline Row row(size_t y) const
+        {
+            size_t offset = y * m_stride;
+            return {m_red.data() + offset, m_green.data() + offset, m_blue.data() + offset, m_alpha.data() + offset,
+                    m_samples.data() + offset};
+        }
+
+        /*!
+         * Remove every sample
+         */
+        void clear()
+        {
+            for(Plane* plane : {&m_red, &m_green, &m_blue, &m_alpha, &m_samples}) {
+                plane->assign(plane->size(), 0.0f);
+            }
+        }
+
+        /*!
+         * @return the number of floats between the start of one row and the start of the next, a multiple of the
+         * number of floats in a cache line
+         */
+        [[nodiscard]] inline size_t getStride() const { return m_stride; }
+
+        [[nodiscard]] inline size_t width() const { return m_width; }
+        [[nodiscard]] inline size_t height() const { return m_height; }
+    };
+}
@@ -1,18 +1,53 @@
 #pragma once
+#include <span>
 #include <vector>
 
 #include "Color.h"
+#include "AlignedAllocator.h"
 #include "json.h"
 
 namespace output
 {
     using namespace color_core;
+
+    /*!
+     * Image stored as a single cache line aligned buffer, one row after the other. Rows are padded out to a whole
+     * number of cache lines, so getStride() may be larger than width().
+     */
     class Image
     {
+    public:
+        static constexpr size_t alignment = 64;
+        using PixelContainer = std::vector<Color, utility::AlignedAllocator<Color, alignment>>;
+
     private:
-        std::vector<std::vector<Color>> m_pixels{};
+        PixelContainer m_pixels{};
+        size_t m_width = 0;
+        size_t m_height = 0;
+        size_t m_stride = 0;
         int m_colorRange = 255;
 
+        /*!
+         * @return \p width rounded up so that every row starts on a cache line
+         */
+        [[nodiscard]] static constexpr size_t getStrideFor(size_t width)
+        {
+            if constexpr (alignment % sizeof(Color) == 0) {
+                constexpr size_t pixels_per_line = alignment / sizeof(Color);
+                return ((width + pixels_per_line - 1) / pixels_per_line) * pixels_per_line;
+            } else {
+                return width;
+            }
+        }
+
+        void allocate(size_t width, size_t height)
+        {
+            m_width = width;
+            m_height = height;
+            m_stride = getStrideFor(width);
+            m_pixels = PixelContainer(m_stride * m_height, Color());
+        }
+
     public:
 
         Image() : Image(0, 0, 255) { }
@@ -28,7 +63,10 @@ namespace output
          * @param height height of the image
          * @param colorRange maximum value for the colors in the image
          */
-        Image(unsigned int width, unsigned int height, int colorRange) : m_pixels(height, std::vector<Color>(width, Color())), m_colorRange(colorRange) { }
+        Image(unsigned int width, unsigned int height, int colorRange) : m_colorRange(colorRange)
+        {
+            allocate(width, height);
+        }
 
         /*!
          * Construct a blank image using parameters from the \p json_file
@@ -53,7 +91,10 @@ namespace output
             } catch(std::exception& e) {
                 throw std::invalid_argument("Could not find the required 'color_range' key. Using " + std::to_string(colorRange));
             }
-            m_pixels     = std::vector<std::vector<Color>>(height, std::vector<Color>(width, Color()));
+            if(width < 0 || height < 0) {
+                throw std::invalid_argument("'width' and 'height' cannot be negative");
+            }
+            allocate(width, height);
             m_colorRange = colorRange;
         }
 
@@ -65,7 +106,10 @@ namespace output
          * @return The Color at the given coordinates
          */
         [[nodiscard]] inline Color at(size_t x, size_t y) const {
-            return m_pixels.at(y).at(x);
+            if(x >= m_width || y >= m_height) {
+                throw std::out_of_range("Image::at - (" + std::to_string(x) + ", " + std::to_string(y) + ") is outside of the image");
+            }
+            return (*this)(x, y);
         }
 
         /*!
@@ -76,18 +120,64 @@ namespace output
          * @return The Color at the given coordinates
          */
         [[nodiscard]] inline Color& at(size_t x, size_t y) {
-            return m_pixels.at(y).at(x);
+            if(x >= m_width || y >= m_height) {
+                throw std::out_of_range("Image::at - (" + std::to_string(x) + ", " + std::to_string(y) + ") is outside of the image");
+            }
+            return (*this)(x, y);
         }
 
+        /*!
+         * Unchecked version of at(), for the render and write loops.
+         * @param x X coordinate. Must be less than width()
+         * @param y Y coordinate. Must be less than height()
+         * @return The Color at the given coordinates
+         */
+        [[nodiscard]] inline const Color& operator()(size_t x, size_t y) const { return m_pixels[(y * m_stride) + x]; }
+
+        /*!
+         * Unchecked version of at(), for the render and write loops.
+         * @param x X coordinate. Must be less than width()
+         * @param y Y coordinate. Must be less than height()
+         * @return The Color at the given coordinates
+         */
+        [[nodiscard]] inline Color& operator()(size_t x, size_t y) { return m_pixels[(y * m_stride) + x]; }
+
+        /*!
+         * @param y index of the row. Must be less than height()
+         * @return a view of the width() pixels of row \p y
+         */
+        [[nodiscard]] inline std::span<const Color> row(size_t y) const { return {m_pixels.data() + (y * m_stride), m_width}; }
+
+        /*!
+         * @param y index of the row. Must be less than height()
+         * @return a view of the width() pixels of row \p y
+         */
+        [[nodiscard]] inline std::span<Color> row(size_t y) { return {m_pixels.data() + (y * m_stride), m_width}; }
+
+        /*!
+         * @return the whole pixel buffer, including any padding at the end of each row
+         */
+        [[nodiscard]] inline std::span<const Color> data() const { return {m_pixels.data(), m_pixels.size()}; }
+
+        /*!
+         * @return the whole pixel buffer, including any padding at the end of each row
+         */
+        [[nodiscard]] inline std::span<Color> data() { return {m_pixels.data(), m_pixels.size()}; }
+
+        /*!
+         * @return the number of pixels between the start of one row and the start of the next
+         */
+        [[nodiscard]] inline size_t getStride() const { return m_stride; }
+
         /*!
          * @return the width of the image
          */
-        [[nodiscard]] inline size_t width()  const { return height() > 0 ? m_pixels.at(0).size() : 0; }
+        [[nodiscard]] inline size_t width()  const { return m_width; }
 
         /*!
          * @return the height of the image
          */
-        [[nodiscard]] inline size_t height() const { return m_pixels.size(); }
+        [[nodiscard]] inline size_t height() const { return m_height; }
 
         /*!
          * get the aspect ratio of the image. Result will be 0 if the height() is 0.
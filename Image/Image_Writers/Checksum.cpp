@@ -0,0 +1,82 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#include <algorithm>
+#include <array>
+
+#include "Checksum.h"
+
+namespace output
+{
+    namespace
+    {
+        constexpr uint32_t adler_modulus = 65521;
+        // the largest number of bytes that can be summed before the 32 bit sums need to be reduced
+        constexpr size_t adler_max_run = 5552;
+
+        constexpr std::array<uint32_t, 256> makeCrcTable()
+        {
+            std::array<uint32_t, 256> table{};
+            for(uint32_t i = 0; i < 256; i++) {
+                uint32_t value = i;
+                for(int bit = 0; bit < 8; bit++) {
+                    value = (value & 1) ? (0xEDB88320 ^ (value >> 1)) : (value >> 1);
+                }
+                table[i] = value;
+            }
+            return table;
+        }
+
+        constexpr std::array<uint32_t, 256> crc_table = makeCrcTable();
+    }
+
+    uint32_t crc32(std::span<const uint8_t> data, uint32_t crc)
+    {
+        crc = ~crc;
+        for(uint8_t byte : data) {
+            crc = crc_table[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    uint32_t adler32(std::span<const uint8_t> data, uint32_t adler)
+    {
+        uint32_t low = adler & 0xFFFF;
+        uint32_t high = adler >> 16;
+        while(!data.empty()) {
+            size_t run = std::min(data.size(), adler_max_run);
+            for(uint8_t byte : data.first(run)) {
+                low += byte;
+                high += low;
+            }
+            low %= adler_modulus;
+            high %= adler_modulus;
+            data = data.subspan(run);
+        }
+        return (high << 16) | low;
+    }
+
+    uint32_t adler32Combine(uint32_t first_adler, uint32_t second_adler, uint64_t second_length)
+    {
+        // see adler32_combine in zlib
+        auto remainder = static_cast<uint32_t>(second_length % adler_modulus);
+        uint32_t low = first_adler & 0xFFFF;
+        uint32_t high = static_cast<uint32_t>((static_cast<uint64_t>(remainder) * low) % adler_modulus);
+        low += (second_adler & 0xFFFF) + adler_modulus - 1;
+        high += (first_adler >> 16) + (second_adler >> 16) + adler_modulus - remainder;
+        if(low >= adler_modulus) {
+            low -= adler_modulus;
+        }
+        if(low >= adler_modulus) {
+            low -= adler_modulus;
+        }
+        if(high >= (adler_modulus << 1)) {
+            high -= (adler_modulus << 1);
+        }
+        if(high >= adler_modulus) {
+            high -= adler_modulus;
+        }
+        return (high << 16) | low;
+    }
+}
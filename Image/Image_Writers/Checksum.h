@@ -0,0 +1,36 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace output
+{
+    /*!
+     * CRC-32 as used by PNG chunks and gzip (polynomial 0xEDB88320)
+     * @param data bytes to checksum
+     * @param crc the crc of any data preceding \p data, so a checksum can be computed in pieces
+     * @return the crc of the preceding data followed by \p data
+     */
+    [[nodiscard]] uint32_t crc32(std::span<const uint8_t> data, uint32_t crc = 0);
+
+    /*!
+     * Adler-32 as used by zlib streams
+     * @param data bytes to checksum
+     * @param adler the checksum of any data preceding \p data
+     * @return the checksum of the preceding data followed by \p data
+     */
+    [[nodiscard]] uint32_t adler32(std::span<const uint8_t> data, uint32_t adler = 1);
+
+    /*!
+     * Combine the checksums of two consecutive pieces of data, so each piece can be checksummed independently
+     * @param first_adler checksum of the first piece
+     * @param second_adler checksum of the second piece
+     * @param second_length length of the second piece in bytes
+     * @return the checksum of the two pieces concatenated
+     */
+    [[nodiscard]] uint32_t adler32Combine(uint32_t first_adler, uint32_t second_adler, uint64_t second_length);
+}
@@ -0,0 +1,559 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+#include "Deflate.h"
+
+namespace output
+{
+    namespace
+    {
+        constexpr size_t window_size = 32768;
+        constexpr size_t min_match = 3;
+        constexpr size_t max_match = 258;
+        constexpr size_t hash_bits = 15;
+        constexpr size_t hash_size = size_t{1} << hash_bits;
+        // how many earlier positions with the same hash are checked for a match
+        constexpr int max_chain = 64;
+        constexpr size_t max_tokens_per_block = size_t{1} << 15;
+        constexpr size_t max_stored_block_size = 65535;
+
+        constexpr size_t number_of_literal_codes = 286;
+        constexpr size_t number_of_distance_codes = 30;
+        constexpr size_t number_of_code_length_codes = 19;
+        constexpr uint16_t end_of_block = 256;
+        constexpr int max_code_length = 15;
+        constexpr int max_code_length_code_length = 7;
+
+        constexpr std::array<uint16_t, 29> length_base = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                                          35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        constexpr std::array<uint8_t, 29> length_extra_bits = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                                               3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        constexpr std::array<uint16_t, 30> distance_base = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257,
+                                                            385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193,
+                                                            12289, 16385, 24577};
+        constexpr std::array<uint8_t, 30> distance_extra_bits = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7,
+                                                                 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+        constexpr std::array<uint8_t, number_of_code_length_codes> code_length_order = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5,
+                                                                                        11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+        /*!
+         * A literal byte (distance of 0) or a back reference of \p value bytes, \p distance bytes back
+         */
+        struct Token
+        {
+            uint16_t value;
+            uint16_t distance;
+        };
+
+        /*!
+         * A symbol of the code length alphabet, plus the value of its extra bits
+         */
+        struct CodeLengthToken
+        {
+            uint8_t symbol;
+            uint8_t extra;
+        };
+
+        [[nodiscard]] size_t lengthCodeIndex(size_t length)
+        {
+            return static_cast<size_t>(std::upper_bound(length_base.begin(), length_base.end(), length) - length_base.begin()) - 1;
+        }
+
+        [[nodiscard]] size_t distanceCodeIndex(size_t distance)
+        {
+            return static_cast<size_t>(std::upper_bound(distance_base.begin(), distance_base.end(), distance) - distance_base.begin()) - 1;
+        }
+
+        /*!
+         * Packs bits least significant bit first, as deflate requires
+         */
+        class BitWriter
+        {
+        private:
+            std::vector<uint8_t>& m_output;
+            uint64_t m_bit_buffer = 0;
+            int m_bit_count = 0;
+
+        public:
+            explicit BitWriter(std::vector<uint8_t>& output) : m_output(output) { }
+
+            void write(uint32_t bits, int count)
+            {
+                m_bit_buffer |= static_cast<uint64_t>(bits) << m_bit_count;
+                m_bit_count += count;
+                while(m_bit_count >= 8) {
+                    m_output.push_back(static_cast<uint8_t>(m_bit_buffer));
+                    m_bit_buffer >>= 8;
+                    m_bit_count -= 8;
+                }
+            }
+
+            void alignToByte()
+            {
+                if(m_bit_count > 0) {
+                    write(0, 8 - m_bit_count);
+                }
+            }
+
+            void writeBytes(std::span<const uint8_t> bytes)
+            {
+                alignToByte();
+                m_output.insert(m_output.end(), bytes.begin(), bytes.end());
+            }
+        };
+
+        /*!
+         * Calculate huffman code lengths for the given symbol \p frequencies, limited to \p max_length bits.
+         * Symbols with a frequency of 0 get a length of 0.
+         */
+        [[nodiscard]] std::vector<uint8_t> buildCodeLengths(const std::vector<uint32_t>& frequencies, int max_length)
+        {
+            std::vector<uint8_t> lengths(frequencies.size(), 0);
+            std::vector<uint32_t> symbols;
+            for(uint32_t symbol = 0; symbol < frequencies.size(); symbol++) {
+                if(frequencies[symbol] > 0) {
+                    symbols.push_back(symbol);
+                }
+            }
+            if(symbols.empty()) {
+                return lengths;
+            }
+            if(symbols.size() == 1) {
+                lengths[symbols[0]] = 1;
+                return lengths;
+            }
+            std::stable_sort(symbols.begin(), symbols.end(), [&](uint32_t a, uint32_t b) { return frequencies[a] < frequencies[b]; });
+
+            // build the tree with the two queue method: leaves are already sorted, and internal nodes are created in
+            // increasing weight order, so the next smallest node is always at the front of one of the two queues
+            size_t leaf_count = symbols.size();
+            size_t node_count = (2 * leaf_count) - 1;
+            std::vector<uint64_t> weights(node_count);
+            std::vector<size_t> parents(node_count, 0);
+            for(size_t i = 0; i < leaf_count; i++) {
+                weights[i] = frequencies[symbols[i]];
+            }
+            size_t next_leaf = 0;
+            size_t next_internal = leaf_count;
+            auto takeSmallest = [&](size_t created) {
+                if(next_leaf < leaf_count && (next_internal >= created || weights[next_leaf] <= weights[next_internal])) {
+                    return next_leaf++;
+                }
+                return next_internal++;
+            };
+            for(size_t node = leaf_count; node < node_count; node++) {
+                size_t first = takeSmallest(node);
+                size_t second = takeSmallest(node);
+                weights[node] = weights[first] + weights[second];
+                parents[first] = node;
+                parents[second] = node;
+            }
+
+            // parents always come after their children, so walking backwards from the root visits parents first
+            std::vector<size_t> depths(node_count, 0);
+            std::vector<size_t> length_counts(leaf_count + 1, 0);
+            for(size_t node = node_count - 1; node-- > 0;) {
+                depths[node] = depths[parents[node]] + 1;
+            }
+            for(size_t leaf = 0; leaf < leaf_count; leaf++) {
+                length_counts[depths[leaf]]++;
+            }
+
+            // squash any codes that are too long, then lengthen shorter codes until the code is complete again
+            std::vector<size_t> limited_counts(max_length + 1, 0);
+            for(size_t length = 1; length < length_counts.size(); length++) {
+                limited_counts[std::min<size_t>(length, max_length)] += length_counts[length];
+            }
+            uint64_t kraft_total = 0;
+            for(int length = 1; length <= max_length; length++) {
+                kraft_total += static_cast<uint64_t>(limited_counts[length]) << (max_length - length);
+            }
+            while(kraft_total > (uint64_t{1} << max_length)) {
+                limited_counts[max_length]--;
+                for(int length = max_length - 1; length > 0; length--) {
+                    if(limited_counts[length] > 0) {
+                        limited_counts[length]--;
+                        limited_counts[length + 1] += 2;
+                        break;
+                    }
+                }
+                kraft_total--;
+            }
+
+            // the least frequent symbols get the longest codes
+            size_t symbol_index = 0;
+            for(int length = max_length; length > 0; length--) {
+                for(size_t i = 0; i < limited_counts[length]; i++) {
+                    lengths[symbols[symbol_index++]] = static_cast<uint8_t>(length);
+                }
+            }
+            return lengths;
+        }
+
+        /*!
+         * Calculate the canonical huffman codes for the given code \p lengths, bit reversed so they can be written
+         * least significant bit first
+         */
+        [[nodiscard]] std::vector<uint16_t> buildCodes(const std::vector<uint8_t>& lengths)
+        {
+            std::array<uint16_t, max_code_length + 1> length_counts{};
+            for(uint8_t length : lengths) {
+                length_counts[length]++;
+            }
+            length_counts[0] = 0;
+            std::array<uint16_t, max_code_length + 2> next_code{};
+            for(int length = 1; length <= max_code_length; length++) {
+                next_code[length + 1] = static_cast<uint16_t>((next_code[length] + length_counts[length]) << 1);
+            }
+            std::vector<uint16_t> codes(lengths.size(), 0);
+            for(size_t symbol = 0; symbol < lengths.size(); symbol++) {
+                int length = lengths[symbol];
+                if(length == 0) {
+                    continue;
+                }
+                uint16_t code = next_code[length]++;
+                uint16_t reversed = 0;
+                for(int bit = 0; bit < length; bit++) {
+                    reversed = static_cast<uint16_t>((reversed << 1) | ((code >> bit) & 1));
+                }
+                codes[symbol] = reversed;
+            }
+            return codes;
+        }
+
+        [[nodiscard]] std::vector<uint8_t> fixedLiteralLengths()
+        {
+            std::vector<uint8_t> lengths(288);
+            std::fill(lengths.begin(), lengths.begin() + 144, 8);
+            std::fill(lengths.begin() + 144, lengths.begin() + 256, 9);
+            std::fill(lengths.begin() + 256, lengths.begin() + 280, 7);
+            std::fill(lengths.begin() + 280, lengths.end(), 8);
+            return lengths;
+        }
+
+        /*!
+         * Run length encode the code lengths of the literal and distance codes with the code length alphabet
+         */
+        [[nodiscard]] std::vector<CodeLengthToken> encodeCodeLengths(const std::vector<uint8_t>& lengths)
+        {
+            std::vector<CodeLengthToken> result;
+            size_t i = 0;
+            while(i < lengths.size()) {
+                uint8_t length = lengths[i];
+                size_t run = 1;
+                while(i + run < lengths.size() && lengths[i + run] == length) {
+                    run++;
+                }
+                size_t remaining = run;
+                if(length == 0) {
+                    while(remaining >= 11) {
+                        size_t count = std::min<size_t>(remaining, 138);
+                        result.push_back({18, static_cast<uint8_t>(count - 11)});
+                        remaining -= count;
+                    }
+                    if(remaining >= 3) {
+                        result.push_back({17, static_cast<uint8_t>(remaining - 3)});
+                        remaining = 0;
+                    }
+                } else {
+                    result.push_back({length, 0});
+                    remaining--;
+                    while(remaining >= 3) {
+                        size_t count = std::min<size_t>(remaining, 6);
+                        result.push_back({16, static_cast<uint8_t>(count - 3)});
+                        remaining -= count;
+                    }
+                }
+                for(; remaining > 0; remaining--) {
+                    result.push_back({length, 0});
+                }
+                i += run;
+            }
+            return result;
+        }
+
+        [[nodiscard]] int codeLengthExtraBits(uint8_t symbol)
+        {
+            switch(symbol) {
+                case 16: return 2;
+                case 17: return 3;
+                case 18: return 7;
+                default: return 0;
+            }
+        }
+
+        /*!
+         * Make sure at least two symbols have a code, so the code is always complete
+         */
+        void ensureTwoSymbols(std::vector<uint32_t>& frequencies, uint16_t first, uint16_t second)
+        {
+            if(std::count_if(frequencies.begin(), frequencies.end(), [](uint32_t frequency) { return frequency > 0; }) < 2) {
+                frequencies[first] = std::max<uint32_t>(frequencies[first], 1);
+                frequencies[second] = std::max<uint32_t>(frequencies[second], 1);
+            }
+        }
+
+        void writeTokens(BitWriter& writer, std::span<const Token> tokens,
+                         const std::vector<uint16_t>& literal_codes, const std::vector<uint8_t>& literal_lengths,
+                         const std::vector<uint16_t>& distance_codes, const std::vector<uint8_t>& distance_lengths)
+        {
+            for(const Token& token : tokens) {
+                if(token.distance == 0) {
+                    writer.write(literal_codes[token.value], literal_lengths[token.value]);
+                    continue;
+                }
+                size_t length_index = lengthCodeIndex(token.value);
+                writer.write(literal_codes[257 + length_index], literal_lengths[257 + length_index]);
+                writer.write(token.value - length_base[length_index], length_extra_bits[length_index]);
+                size_t distance_index = distanceCodeIndex(token.distance);
+                writer.write(distance_codes[distance_index], distance_lengths[distance_index]);
+                writer.write(token.distance - distance_base[distance_index], distance_extra_bits[distance_index]);
+            }
+            writer.write(literal_codes[end_of_block], literal_lengths[end_of_block]);
+        }
+
+        void writeStoredBlocks(BitWriter& writer, std::span<const uint8_t> bytes, bool is_final)
+        {
+            do {
+                size_t size = std::min(bytes.size(), max_stored_block_size);
+                bool is_last_chunk = size == bytes.size();
+                writer.write((is_final && is_last_chunk) ? 1 : 0, 1);
+                writer.write(0, 2);
+                writer.alignToByte();
+                writer.write(static_cast<uint32_t>(size), 16);
+                writer.write(static_cast<uint32_t>(~size & 0xFFFF), 16);
+                writer.writeBytes(bytes.first(size));
+                bytes = bytes.subspan(size);
+            } while(!bytes.empty());
+        }
+
+        /*!
+         * Write one block holding \p tokens, which encode \p bytes, in whichever encoding is smallest
+         */
+        void writeBlock(BitWriter& writer, std::span<const Token> tokens, std::span<const uint8_t> bytes, bool is_final)
+        {
+            std::vector<uint32_t> literal_frequencies(number_of_literal_codes, 0);
+            std::vector<uint32_t> distance_frequencies(number_of_distance_codes, 0);
+            uint64_t extra_bits = 0;
+            for(const Token& token : tokens) {
+                if(token.distance == 0) {
+                    literal_frequencies[token.value]++;
+                    continue;
+                }
+                size_t length_index = lengthCodeIndex(token.value);
+                size_t distance_index = distanceCodeIndex(token.distance);
+                literal_frequencies[257 + length_index]++;
+                distance_frequencies[distance_index]++;
+                extra_bits += length_extra_bits[length_index] + distance_extra_bits[distance_index];
+            }
+            literal_frequencies[end_of_block]++;
+
+            auto dataBits = [&](const std::vector<uint8_t>& literal_lengths, const std::vector<uint8_t>& distance_lengths) {
+                uint64_t bits = extra_bits;
+                for(size_t symbol = 0; symbol < number_of_literal_codes; symbol++) {
+                    bits += static_cast<uint64_t>(literal_frequencies[symbol]) * literal_lengths[symbol];
+                }
+                for(size_t symbol = 0; symbol < number_of_distance_codes; symbol++) {
+                    bits += static_cast<uint64_t>(distance_frequencies[symbol]) * distance_lengths[symbol];
+                }
+                return bits;
+            };
+
+            // dynamic codes
+            std::vector<uint32_t> literal_code_frequencies = literal_frequencies;
+            std::vector<uint32_t> distance_code_frequencies = distance_frequencies;
+            ensureTwoSymbols(literal_code_frequencies, 0, end_of_block);
+            ensureTwoSymbols(distance_code_frequencies, 0, 1);
+            std::vector<uint8_t> literal_lengths = buildCodeLengths(literal_code_frequencies, max_code_length);
+            std::vector<uint8_t> distance_lengths = buildCodeLengths(distance_code_frequencies, max_code_length);
+
+            size_t literal_count = number_of_literal_codes;
+            while(literal_count > 257 && literal_lengths[literal_count - 1] == 0) {
+                literal_count--;
+            }
+            size_t distance_count = number_of_distance_codes;
+            while(distance_count > 1 && distance_lengths[distance_count - 1] == 0) {
+                distance_count--;
+            }
+            std::vector<uint8_t> all_lengths(literal_lengths.begin(), literal_lengths.begin() + static_cast<std::ptrdiff_t>(literal_count));
+            all_lengths.insert(all_lengths.end(), distance_lengths.begin(), distance_lengths.begin() + static_cast<std::ptrdiff_t>(distance_count));
+            std::vector<CodeLengthToken> code_length_tokens = encodeCodeLengths(all_lengths);
+
+            std::vector<uint32_t> code_length_frequencies(number_of_code_length_codes, 0);
+            for(const CodeLengthToken& token : code_length_tokens) {
+                code_length_frequencies[token.symbol]++;
+            }
+            std::vector<uint32_t> code_length_code_frequencies = code_length_frequencies;
+            ensureTwoSymbols(code_length_code_frequencies, 0, 1);
+            std::vector<uint8_t> code_length_lengths = buildCodeLengths(code_length_code_frequencies, max_code_length_code_length);
+            size_t code_length_count = number_of_code_length_codes;
+            while(code_length_count > 4 && code_length_lengths[code_length_order[code_length_count - 1]] == 0) {
+                code_length_count--;
+            }
+
+            uint64_t dynamic_bits = 3 + 5 + 5 + 4 + (3 * code_length_count) + dataBits(literal_lengths, distance_lengths);
+            for(const CodeLengthToken& token : code_length_tokens) {
+                dynamic_bits += code_length_lengths[token.symbol] + codeLengthExtraBits(token.symbol);
+            }
+
+            // fixed codes
+            std::vector<uint8_t> fixed_literal_lengths = fixedLiteralLengths();
+            std::vector<uint8_t> fixed_distance_lengths(number_of_distance_codes, 5);
+            uint64_t fixed_bits = 3 + dataBits(fixed_literal_lengths, fixed_distance_lengths);
+
+            // stored, counting the worst case padding and the length fields of each stored block
+            size_t stored_block_count = std::max<size_t>(1, (bytes.size() + max_stored_block_size - 1) / max_stored_block_size);
+            uint64_t stored_bits = (8 * bytes.size()) + (stored_block_count * (3 + 7 + 32));
+
+            if(stored_bits <= dynamic_bits && stored_bits <= fixed_bits) {
+                writeStoredBlocks(writer, bytes, is_final);
+            } else if(fixed_bits <= dynamic_bits) {
+                writer.write(is_final ? 1 : 0, 1);
+                writer.write(1, 2);
+                writeTokens(writer, tokens, buildCodes(fixed_literal_lengths), fixed_literal_lengths,
+                            buildCodes(fixed_distance_lengths), fixed_distance_lengths);
+            } else {
+                writer.write(is_final ? 1 : 0, 1);
+                writer.write(2, 2);
+                writer.write(static_cast<uint32_t>(literal_count - 257), 5);
+                writer.write(static_cast<uint32_t>(distance_count - 1), 5);
+                writer.write(static_cast<uint32_t>(code_length_count - 4), 4);
+                for(size_t i = 0; i < code_length_count; i++) {
+                    writer.write(code_length_lengths[code_length_order[i]], 3);
+                }
+                std::vector<uint16_t> code_length_codes = buildCodes(code_length_lengths);
+                for(const CodeLengthToken& token : code_length_tokens) {
+                    writer.write(code_length_codes[token.symbol], code_length_lengths[token.symbol]);
+                    writer.write(token.extra, codeLengthExtraBits(token.symbol));
+                }
+                writeTokens(writer, tokens, buildCodes(literal_lengths), literal_lengths,
+                            buildCodes(distance_lengths), distance_lengths);
+            }
+        }
+
+        /*!
+         * Finds LZ77 matches using hash chains over the last window_size bytes
+         */
+        class MatchFinder
+        {
+        private:
+            std::span<const uint8_t> m_data;
+            std::vector<int32_t> m_head;
+            std::vector<int32_t> m_previous;
+
+            [[nodiscard]] size_t hash(size_t position) const
+            {
+                uint32_t value = m_data[position] | (m_data[position + 1] << 8) | (m_data[position + 2] << 16);
+                return (value * 2654435761u) >> (32 - hash_bits);
+            }
+
+        public:
+            explicit MatchFinder(std::span<const uint8_t> data)
+                : m_data(data), m_head(hash_size, -1), m_previous(window_size, -1) { }
+
+            void insert(size_t position)
+            {
+                if(position + min_match > m_data.size()) {
+                    return;
+                }
+                size_t bucket = hash(position);
+                m_previous[position & (window_size - 1)] = m_head[bucket];
+                m_head[bucket] = static_cast<int32_t>(position);
+            }
+
+            /*!
+             * @return the longest match for the bytes at \p position, as a length/distance token. The length is 0 if
+             * there is no match of at least min_match bytes
+             */
+            [[nodiscard]] Token findMatch(size_t position) const
+            {
+                Token best{0, 0};
+                if(position + min_match > m_data.size()) {
+                    return best;
+                }
+                size_t max_length = std::min(max_match, m_data.size() - position);
+                size_t best_length = 0;
+                int32_t candidate = m_head[hash(position)];
+                for(int chain = 0; candidate >= 0 && chain < max_chain; chain++) {
+                    size_t distance = position - static_cast<size_t>(candidate);
+                    if(distance > window_size) {
+                        break;
+                    }
+                    if(m_data[candidate + best_length] == m_data[position + best_length]) {
+                        size_t length = 0;
+                        while(length < max_length && m_data[candidate + length] == m_data[position + length]) {
+                            length++;
+                        }
+                        if(length > best_length) {
+                            best_length = length;
+                            best = {static_cast<uint16_t>(length), static_cast<uint16_t>(distance)};
+                            if(length == max_length) {
+                                break;
+                            }
+                        }
+                    }
+                    int32_t next = m_previous[static_cast<size_t>(candidate) & (window_size - 1)];
+                    if(next >= candidate) {
+                        break;  // the slot was reused by a newer position
+                    }
+                    candidate = next;
+                }
+                if(best_length < min_match) {
+                    return {0, 0};
+                }
+                return best;
+            }
+        };
+    }
+
+    std::vector<uint8_t> deflate(std::span<const uint8_t> data, bool is_last_piece)
+    {
+        std::vector<uint8_t> output;
+        output.reserve((data.size() / 2) + 64);
+        BitWriter writer(output);
+
+        MatchFinder matches(data);
+        std::vector<Token> tokens;
+        tokens.reserve(std::min(data.size(), max_tokens_per_block));
+        size_t position = 0;
+        size_t block_start = 0;
+        while(position < data.size()) {
+            tokens.clear();
+            block_start = position;
+            while(position < data.size() && tokens.size() < max_tokens_per_block) {
+                Token match = matches.findMatch(position);
+                if(match.value == 0) {
+                    tokens.push_back({data[position], 0});
+                    matches.insert(position);
+                    position++;
+                    continue;
+                }
+                tokens.push_back(match);
+                for(size_t i = 0; i < match.value; i++) {
+                    matches.insert(position + i);
+                }
+                position += match.value;
+            }
+            writeBlock(writer, tokens, data.subspan(block_start, position - block_start), is_last_piece && position == data.size());
+        }
+
+        if(is_last_piece) {
+            if(data.empty()) {
+                // a final fixed block holding only the end of block code
+                writer.write(1, 1);
+                writer.write(1, 2);
+                writer.write(0, 7);
+            }
+            writer.alignToByte();
+        } else {
+            // an empty stored block byte aligns the output without ending the stream
+            writeStoredBlocks(writer, {}, false);
+        }
+        return output;
+    }
+}
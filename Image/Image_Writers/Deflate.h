@@ -0,0 +1,25 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace output
+{
+    /*!
+     * Compress \p data into raw deflate blocks (RFC 1951), using LZ77 with hash chains and per block dynamic, fixed or
+     * stored encoding, whichever is smallest.
+     *
+     * Pieces of a larger stream can be compressed independently and concatenated: a piece that isn't the last one ends
+     * with an empty stored block, which byte aligns the output without ending the stream. Matches never reach back
+     * into a previous piece.
+     * @param data the bytes to compress
+     * @param is_last_piece true if this is the end of the stream, which marks the final block as such
+     * @return the compressed bytes
+     */
+    [[nodiscard]] std::vector<uint8_t> deflate(std::span<const uint8_t> data, bool is_last_piece);
+}
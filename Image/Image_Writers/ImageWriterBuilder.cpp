@@ -17,9 +17,9 @@ namespace output
         {"png", "png"}, {"PNG", "png"}
     };
 
-    std::unique_ptr<ImageWriter_I> ImageWriterBuilder::createPPMWriter()
+    std::unique_ptr<ImageWriter_I> ImageWriterBuilder::createPPMWriter(PPMImageWriter::Format format)
     {
-        return std::make_unique<PPMImageWriter>();
+        return std::make_unique<PPMImageWriter>(format);
     }
 
     std::unique_ptr<ImageWriter_I> ImageWriterBuilder::createPNGWriter()
@@ -30,11 +30,31 @@ namespace output
     std::unique_ptr<ImageWriter_I> ImageWriterBuilder::createWriter(const std::string& file_suffix)
     {
         if(suffix_map[file_suffix] == "ppm") {
-            return createPPMWriter();
+            return createPPMWriter(PPMImageWriter::Format::Ascii);
         } else if(suffix_map[file_suffix] == "png") {
             return createPNGWriter();
         }
         return nullptr;
     }
 
+    std::unique_ptr<ImageWriter_I> ImageWriterBuilder::createWriter(const nlohmann::json& output_config)
+    {
+        std::string file_path;
+        try {
+            file_path = output_config.at("file_path").get<std::string>();
+        } catch(std::exception& e) {
+            throw std::invalid_argument("Could not find the required 'file_path' key.");
+        }
+        std::string file_suffix = file_path.substr(file_path.find_last_of('.') + 1);
+
+        if(suffix_map[file_suffix] == "ppm") {
+            PPMImageWriter::Format format = PPMImageWriter::Format::Ascii;
+            if(output_config.contains("ppm_format")) {
+                format = PPMImageWriter::FormatFromString(output_config.at("ppm_format").get<std::string>());
+            }
+            return createPPMWriter(format);
+        }
+        return createWriter(file_suffix);
+    }
+
 }
\ No newline at end of file
@@ -10,16 +10,25 @@
 #include "ImageWriter_I.h"
 #include "PNGImageWriter.h"
 #include "PPMImageWriter.h"
+#include "json.h"
 
 namespace output {
     class ImageWriterBuilder {
     private:
-        static std::unique_ptr<ImageWriter_I> createPPMWriter();
+        static std::unique_ptr<ImageWriter_I> createPPMWriter(PPMImageWriter::Format format);
         static std::unique_ptr<ImageWriter_I> createPNGWriter();
 
         static std::map<std::string, std::string> suffix_map;
 
     public:
         static std::unique_ptr<ImageWriter_I> createWriter(const std::string& file_suffix);
+
+        /*!
+         * Create a writer for the "file_path" in the \p output_config, using any format options it contains.
+         * Recognized options are "ppm_format" ("ascii" or "binary").
+         * @param output_config json config for the output
+         * @return the writer, or nullptr if the file type isn't supported
+         */
+        static std::unique_ptr<ImageWriter_I> createWriter(const nlohmann::json& output_config);
     };
 }
\ No newline at end of file
@@ -2,30 +2,249 @@
 // Created by olber on 9/4/2022.
 //
 
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
 
 #include "Image.h"
 #include "Color.h"
+#include "Endian.h"
+#include "Checksum.h"
+#include "Deflate.h"
+#include "Parallel.h"
 #include "PNGImageWriter.h"
-//#include <Magick++.h>
 
 namespace output
 {
+    namespace
+    {
+        constexpr std::array<uint8_t, 8> png_signature = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        // deflate with a 32K window, no preset dictionary, and a check value that makes the header a multiple of 31
+        constexpr std::array<uint8_t, 2> zlib_header = {0x78, 0x01};
+        constexpr uint8_t color_type_truecolor = 2;
+        // strips smaller than this compress noticeably worse, since matches can't reach across strips
+        constexpr size_t min_rows_per_strip = 16;
+
+        enum Filter : uint8_t
+        {
+            None = 0,
+            Sub = 1,
+            Up = 2,
+            Average = 3,
+            Paeth = 4
+        };
+
+        /*!
+         * A strip of rows, filtered and compressed, ready to be written out as an IDAT chunk
+         */
+        struct Strip
+        {
+            std::vector<uint8_t> chunk_data;
+            uint32_t chunk_crc = 0;
+            uint32_t adler = 1;
+            size_t uncompressed_size = 0;
+        };
+
+        void appendBigEndian(std::vector<uint8_t>& bytes, uint32_t value)
+        {
+            uint32_t big_endian = utility::ToBigEndian(value);
+            const auto* value_bytes = reinterpret_cast<const uint8_t*>(&big_endian);
+            bytes.insert(bytes.end(), value_bytes, value_bytes + sizeof(big_endian));
+        }
+
+        [[nodiscard]] uint32_t chunkCrc(const char* type, std::span<const uint8_t> data)
+        {
+            uint32_t crc = crc32({reinterpret_cast<const uint8_t*>(type), 4});
+            return crc32(data, crc);
+        }
+
+        void writeChunk(std::ofstream& out, const char* type, std::span<const uint8_t> data, uint32_t crc)
+        {
+            std::vector<uint8_t> header;
+            appendBigEndian(header, static_cast<uint32_t>(data.size()));
+            header.insert(header.end(), type, type + 4);
+            std::vector<uint8_t> footer;
+            appendBigEndian(footer, crc);
+            out.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+            out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            out.write(reinterpret_cast<const char*>(footer.data()), static_cast<std::streamsize>(footer.size()));
+        }
+
+        void writeChunk(std::ofstream& out, const char* type, std::span<const uint8_t> data)
+        {
+            writeChunk(out, type, data, chunkCrc(type, data));
+        }
+
+        /*!
+         * Convert row \p y of \p image into PNG samples, scaled from the image's color range to the full range of the
+         * sample size
+         */
+        void convertRow(const Image& image, size_t y, size_t bytes_per_sample, std::vector<uint8_t>& samples)
+        {
+            const uint64_t color_range = static_cast<uint64_t>(std::max(image.getColorRange(), 1));
+            const uint64_t sample_max = bytes_per_sample == 2 ? 65535 : 255;
+            auto scale = [&](int value) {
+                auto clamped = static_cast<uint64_t>(std::clamp<int64_t>(value, 0, static_cast<int64_t>(color_range)));
+                return color_range == sample_max ? clamped : ((clamped * sample_max) + (color_range / 2)) / color_range;
+            };
+
+            uint8_t* bytes = samples.data();
+            for(const Color& pixel : image.row(y)) {
+                for(int channel : {pixel.R(), pixel.G(), pixel.B()}) {
+                    uint64_t value = scale(channel);
+                    if(bytes_per_sample == 2) {
+                        *bytes++ = static_cast<uint8_t>(value >> 8);
+                    }
+                    *bytes++ = static_cast<uint8_t>(value);
+                }
+            }
+        }
+
+        [[nodiscard]] uint8_t paethPredictor(int left, int up, int up_left)
+        {
+            int estimate = left + up - up_left;
+            int left_distance = std::abs(estimate - left);
+            int up_distance = std::abs(estimate - up);
+            int up_left_distance = std::abs(estimate - up_left);
+            if(left_distance <= up_distance && left_distance <= up_left_distance) {
+                return static_cast<uint8_t>(left);
+            } else if(up_distance <= up_left_distance) {
+                return static_cast<uint8_t>(up);
+            }
+            return static_cast<uint8_t>(up_left);
+        }
+
+        /*!
+         * Filter \p row with every filter type and append the one with the smallest sum of absolute differences,
+         * preceded by its filter type byte, to \p output
+         * @param row the samples of the row to filter
+         * @param previous the samples of the row above, all zero for the first row of the image
+         * @param bytes_per_pixel distance in bytes to the corresponding sample of the pixel to the left
+         * @param candidate scratch space the size of \p row
+         */
+        void filterRow(std::span<const uint8_t> row, std::span<const uint8_t> previous, size_t bytes_per_pixel,
+                       std::vector<uint8_t>& candidate, std::vector<uint8_t>& output)
+        {
+            auto applyFilter = [&](Filter filter) {
+                for(size_t i = 0; i < row.size(); i++) {
+                    int left = i >= bytes_per_pixel ? row[i - bytes_per_pixel] : 0;
+                    int up = previous[i];
+                    int up_left = i >= bytes_per_pixel ? previous[i - bytes_per_pixel] : 0;
+                    uint8_t prediction = 0;
+                    switch(filter) {
+                        case None:    prediction = 0; break;
+                        case Sub:     prediction = static_cast<uint8_t>(left); break;
+                        case Up:      prediction = static_cast<uint8_t>(up); break;
+                        case Average: prediction = static_cast<uint8_t>((left + up) / 2); break;
+                        case Paeth:   prediction = paethPredictor(left, up, up_left); break;
+                    }
+                    candidate[i] = static_cast<uint8_t>(row[i] - prediction);
+                }
+            };
+            // treat the filtered bytes as signed, so small negative differences count as small
+            auto cost = [&]() {
+                uint64_t sum = 0;
+                for(uint8_t value : candidate) {
+                    sum += static_cast<uint64_t>(std::abs(static_cast<int>(static_cast<int8_t>(value))));
+                }
+                return sum;
+            };
+
+            Filter best_filter = None;
+            uint64_t best_cost = std::numeric_limits<uint64_t>::max();
+            for(Filter filter : {None, Sub, Up, Average, Paeth}) {
+                applyFilter(filter);
+                uint64_t filter_cost = cost();
+                if(filter_cost < best_cost) {
+                    best_cost = filter_cost;
+                    best_filter = filter;
+                }
+            }
+            applyFilter(best_filter);
+            output.push_back(best_filter);
+            output.insert(output.end(), candidate.begin(), candidate.end());
+        }
+
+        /*!
+         * Filter and compress rows [\p begin, \p end) of \p image
+         */
+        [[nodiscard]] Strip compressStrip(const Image& image, size_t begin, size_t end, size_t bytes_per_sample, bool is_first, bool is_last)
+        {
+            const size_t bytes_per_pixel = 3 * bytes_per_sample;
+            const size_t row_size = image.width() * bytes_per_pixel;
+            std::vector<uint8_t> previous(row_size, 0);
+            std::vector<uint8_t> current(row_size);
+            std::vector<uint8_t> candidate(row_size);
+            if(begin > 0) {
+                convertRow(image, begin - 1, bytes_per_sample, previous);
+            }
+
+            std::vector<uint8_t> filtered;
+            filtered.reserve((end - begin) * (row_size + 1));
+            for(size_t y = begin; y < end; y++) {
+                convertRow(image, y, bytes_per_sample, current);
+                filterRow(current, previous, bytes_per_pixel, candidate, filtered);
+                std::swap(current, previous);
+            }
+
+            Strip strip;
+            strip.uncompressed_size = filtered.size();
+            strip.adler = adler32(filtered);
+            if(is_first) {
+                strip.chunk_data.assign(zlib_header.begin(), zlib_header.end());
+            }
+            std::vector<uint8_t> compressed = deflate(filtered, is_last);
+            strip.chunk_data.insert(strip.chunk_data.end(), compressed.begin(), compressed.end());
+            strip.chunk_crc = chunkCrc("IDAT", strip.chunk_data);
+            return strip;
+        }
+    }
+
     void PNGImageWriter::write(const Image& image, const std::string& filepath)
     {
-//        auto toMagickColor = [](const color_core::Color& color) {
-//            return Magick::Color(color.R(), color.G(), color.B(), color.Alpha());
-//        };
-//        Magick::Image magickImage = Magick::Image();
-//        magickImage.size(Magick::Geometry(image.width(), image.height()));
-//        magickImage.colorSpace(Magick::ColorspaceType::sRGBColorspace);
-//        magickImage.type(Magick::PaletteAlphaType);
-//        magickImage.quantizeColors(256);
-//        for(int i = 0; i < image.width(); i++) {
-//            for(int j = 0; j < image.height(); j++) {
-//                magickImage.pixelColor(i, j, toMagickColor(image.at(i, j)));
-//            }
-//        }
-//        magickImage.write(filepath);
+        if(image.width() == 0 || image.height() == 0) {
+            throw std::invalid_argument("PNG images must be at least 1 pixel wide and tall");
+        }
+        std::ofstream out(filepath, std::ios::binary);
+        if(!out.is_open()) {
+            throw std::runtime_error("Could not open " + filepath + " for writing");
+        }
+
+        const size_t bytes_per_sample = image.getColorRange() > 255 ? 2 : 1;
+
+        std::vector<uint8_t> header;
+        appendBigEndian(header, static_cast<uint32_t>(image.width()));
+        appendBigEndian(header, static_cast<uint32_t>(image.height()));
+        header.push_back(static_cast<uint8_t>(8 * bytes_per_sample));
+        header.push_back(color_type_truecolor);
+        header.push_back(0);  // compression method: deflate
+        header.push_back(0);  // filter method: adaptive
+        header.push_back(0);  // interlace method: none
+
+        size_t max_strips = std::max<size_t>(1, image.height() / min_rows_per_strip);
+        size_t strip_count = std::min(utility::concurrency(), max_strips);
+        std::vector<Strip> strips(strip_count);
+        utility::parallelFor(strip_count, [&](size_t i) {
+            size_t begin = (image.height() * i) / strip_count;
+            size_t end = (image.height() * (i + 1)) / strip_count;
+            strips[i] = compressStrip(image, begin, end, bytes_per_sample, i == 0, i + 1 == strip_count);
+        });
+
+        out.write(reinterpret_cast<const char*>(png_signature.data()), png_signature.size());
+        writeChunk(out, "IHDR", header);
+        uint32_t adler = 1;
+        for(const Strip& strip : strips) {
+            adler = adler32Combine(adler, strip.adler, strip.uncompressed_size);
+            writeChunk(out, "IDAT", strip.chunk_data, strip.chunk_crc);
+        }
+        std::vector<uint8_t> trailer;
+        appendBigEndian(trailer, adler);
+        writeChunk(out, "IDAT", trailer);
+        writeChunk(out, "IEND", {});
     }
-}
\ No newline at end of file
+}
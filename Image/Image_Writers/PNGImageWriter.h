@@ -10,6 +10,11 @@
 #include "ImageWriter_I.h"
 
 namespace output {
+    /*!
+     * Writes truecolor PNG images, 8 bits per channel, or 16 when the color range is over 255.
+     * The image is split into strips of rows which are filtered and compressed in parallel, on the current
+     * utility::ThreadPool if there is one; each strip becomes its own IDAT chunk of a single zlib stream.
+     */
     class PNGImageWriter : public ImageWriter_I
     {
     public:
@@ -17,4 +22,4 @@ namespace output {
 
         void write(const Image& image, const std::string& filepath) override;
     };
-}
\ No newline at end of file
+}
@@ -1,6 +1,8 @@
 //
 // Created by olber on 8/27/2022.
 //
+#include <algorithm>
+#include <charconv>
 #include <fstream>
 
 #include "Image.h"
@@ -8,17 +10,85 @@
 
 namespace output
 {
+    namespace
+    {
+        // flush the buffer to disk once it holds at least this many bytes
+        constexpr size_t block_size = 1 << 20;
+    }
+
+    PPMImageWriter::Format PPMImageWriter::FormatFromString(const std::string& format_name)
+    {
+        if(format_name == "ascii") {
+            return Format::Ascii;
+        } else if(format_name == "binary") {
+            return Format::Binary;
+        }
+        throw std::invalid_argument("ppm format must be one of the following values: \n [ascii, binary]. got " + format_name);
+    }
+
     void PPMImageWriter::write(const Image& image, const std::string& filepath)
     {
-        std::ofstream out(filepath);
-        out << "P3" << "\n";
+        std::ofstream out(filepath, std::ios::binary);
+        out << (m_format == Format::Binary ? "P6" : "P3") << "\n";
         out << image.width() << " " << image.height() << "\n";
         out << image.getColorRange() << "\n";
-        for(int j = 0; j < image.height(); j++) {
-            for(int i = 0; i < image.width(); i++) {
-                out << image.at(i, j).to_string() << " ";
+        if(m_format == Format::Binary) {
+            writeBinary(image, out);
+        } else {
+            writeAscii(image, out);
+        }
+    }
+
+    void PPMImageWriter::writeAscii(const Image& image, std::ofstream& out)
+    {
+        // every pixel is at most three 11 character integers and their separators
+        constexpr size_t max_pixel_size = 3 * 12;
+        size_t row_size = (image.width() * max_pixel_size) + 1;
+        m_buffer.resize(std::max(block_size, row_size) + row_size);
+
+        size_t used = 0;
+        for(size_t j = 0; j < image.height(); j++) {
+            for(const Color& pixel : image.row(j)) {
+                for(int channel : {pixel.R(), pixel.G(), pixel.B()}) {
+                    used = std::to_chars(m_buffer.data() + used, m_buffer.data() + m_buffer.size(), channel).ptr - m_buffer.data();
+                    m_buffer[used++] = ' ';
+                }
+            }
+            m_buffer[used++] = '\n';
+            if(used >= block_size) {
+                out.write(m_buffer.data(), static_cast<std::streamsize>(used));
+                used = 0;
+            }
+        }
+        out.write(m_buffer.data(), static_cast<std::streamsize>(used));
+    }
+
+    void PPMImageWriter::writeBinary(const Image& image, std::ofstream& out)
+    {
+        const int color_range = image.getColorRange();
+        const size_t bytes_per_channel = color_range > 255 ? 2 : 1;
+        size_t row_size = image.width() * 3 * bytes_per_channel;
+        size_t rows_per_block = std::max<size_t>(1, block_size / std::max<size_t>(row_size, 1));
+        m_buffer.resize(rows_per_block * row_size);
+
+        auto clampChannel = [color_range](int value) { return static_cast<unsigned int>(std::clamp(value, 0, color_range)); };
+
+        for(size_t block_start = 0; block_start < image.height(); block_start += rows_per_block) {
+            size_t block_end = std::min(block_start + rows_per_block, image.height());
+            auto* bytes = reinterpret_cast<unsigned char*>(m_buffer.data());
+            for(size_t j = block_start; j < block_end; j++) {
+                for(const Color& pixel : image.row(j)) {
+                    for(int channel : {pixel.R(), pixel.G(), pixel.B()}) {
+                        unsigned int value = clampChannel(channel);
+                        // 16 bit samples are stored most significant byte first
+                        if(bytes_per_channel == 2) {
+                            *bytes++ = static_cast<unsigned char>(value >> 8);
+                        }
+                        *bytes++ = static_cast<unsigned char>(value);
+                    }
+                }
             }
-            out << "\n";
+            out.write(m_buffer.data(), static_cast<std::streamsize>((block_end - block_start) * row_size));
         }
     }
-}
\ No newline at end of file
+}
@@ -5,15 +5,38 @@
 #pragma once
 #include <string>
 #include <fstream>
+#include <vector>
 #include "Image.h"
 #include "ImageWriter_I.h"
 
 namespace output {
     class PPMImageWriter : public ImageWriter_I
     {
+    public:
+        enum class Format
+        {
+            Ascii,  // P3
+            Binary  // P6, 16 bits per channel when the color range is over 255
+        };
+
+    private:
+        Format m_format = Format::Ascii;
+        // rows are converted into this buffer and written out in large blocks. kept around between writes
+        std::vector<char> m_buffer;
+
+        void writeAscii(const Image& image, std::ofstream& out);
+        void writeBinary(const Image& image, std::ofstream& out);
+
     public:
         PPMImageWriter() = default;
+        explicit PPMImageWriter(Format format) : m_format(format) { }
+
+        /*!
+         * @param format_name either "ascii" or "binary"
+         * @return the corresponding Format
+         */
+        static Format FormatFromString(const std::string& format_name);
 
         void write(const Image& image, const std::string& filepath) override;
     };
-}
\ No newline at end of file
+}
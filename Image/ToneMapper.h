@@ -0,0 +1,237 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#include "Color.h"
+#include "Image.h"
+#include "AccumulationBuffer.h"
+#include "SimdPack.h"
+#include "json.h"
+
+namespace output
+{
+    using namespace color_core;
+
+    /*!
+     * How radiance beyond display white is brought into range
+     */
+    enum class ToneMapOperator
+    {
+        // scale and clamp, so anything brighter than white is cut off
+        Linear,
+        // x / (1 + x), which never quite reaches white
+        Reinhard,
+        // Narkowicz's fit of the ACES filmic curve
+        ACES
+    };
+
+    /*!
+     * @param operator_name one of "linear", "reinhard" or "aces"
+     * @return the corresponding ToneMapOperator
+     */
+    [[nodiscard]] inline ToneMapOperator ToneMapOperatorFromString(const std::string& operator_name)
+    {
+        if(operator_name == "linear") {
+            return ToneMapOperator::Linear;
+        } else if(operator_name == "reinhard") {
+            return ToneMapOperator::Reinhard;
+        } else if(operator_name == "aces") {
+            return ToneMapOperator::ACES;
+        }
+        throw std::invalid_argument("tone map must be one of the following values: \n [linear, reinhard, aces]. got " + operator_name);
+    }
+
+    /*!
+     * Turns an AccumulationBuffer into an Image in a single pass: averages each pixel's samples, applies the exposure
+     * and tone map operator, optionally encodes to sRGB, and quantizes to the image's color range. The whole pass works
+     * on linear_algebra_core::simd::Pack<float>, so it vectorizes with the rest of the kernels.
+     *
+     * Scene colors are given on a 0 to 255 scale, so 255 is display white before exposure.
+     */
+    class ToneMapper
+    {
+    private:
+        using Pack = linear_algebra_core::simd::Pack<float>;
+
+        static constexpr float reference_white = 255.0f;
+
+        ToneMapOperator m_operator = ToneMapOperator::Linear;
+        float m_exposure = 1.0f;
+        bool m_srgb = false;
+
+        [[nodiscard]] static Pack clamp(const Pack& value, const Pack& low, const Pack& high)
+        {
+            Pack above_low = Pack::select(value < low, low, value);
+            return Pack::select(above_low > high, high, above_low);
+        }
+
+        template<ToneMapOperator tone_map_operator>
+        [[nodiscard]] static Pack toneMap(const Pack& value)
+        {
+            const Pack zero = Pack::broadcast(0.0f);
+            const Pack one = Pack::broadcast(1.0f);
+            Pack x = Pack::select(value < zero, zero, value);
+            if constexpr (tone_map_operator == ToneMapOperator::Reinhard) {
+                x = x / (one + x);
+            } else if constexpr (tone_map_operator == ToneMapOperator::ACES) {
+                x = (x * ((Pack::broadcast(2.51f) * x) + Pack::broadcast(0.03f))) /
+                    ((x * ((Pack::broadcast(2.43f) * x) + Pack::broadcast(0.59f))) + Pack::broadcast(0.14f));
+            }
+            return clamp(x, zero, one);
+        }
+
+        /*!
+         * The sRGB transfer function of \p linear in [0, 1]. x^(1/2.4) is first approximated from square roots, then
+         * refined with two Newton steps on y^12 = x^5, which is within 2e-7 of std::pow: exact even at 16 bits.
+         */
+        [[nodiscard]] static Pack encodeSrgb(const Pack& linear)
+        {
+            Pack root_2 = linear.sqrt();
+            Pack root_4 = root_2.sqrt();
+            Pack root_8 = root_4.sqrt();
+            Pack encoded = (Pack::broadcast(0.662002687f) * root_2) + (Pack::broadcast(0.684122060f) * root_4) -
+                           (Pack::broadcast(0.323583601f) * root_8) - (Pack::broadcast(0.0225411470f) * linear);
+            Pack y = (encoded + Pack::broadcast(0.055f)) / Pack::broadcast(1.055f);
+
+            Pack linear_squared = linear * linear;
+            Pack linear_5 = linear_squared * linear_squared * linear;
+            for(int step = 0; step < 2; step++) {
+                Pack y_2 = y * y;
+                Pack y_4 = y_2 * y_2;
+                Pack y_11 = y_4 * y_4 * y_2 * y;
+                y = (y * Pack::broadcast(11.0f / 12.0f)) + (linear_5 / (Pack::broadcast(12.0f) * y_11));
+            }
+            Pack curve = (Pack::broadcast(1.055f) * y) - Pack::broadcast(0.055f);
+            return Pack::select(linear <= Pack::broadcast(0.0031308f), Pack::broadcast(12.92f) * linear, curve);
+        }
+
+        template<ToneMapOperator tone_map_operator, bool srgb>
+        void applyTo(const AccumulationBuffer& buffer, Image& image) const
+        {
+            const Pack zero = Pack::broadcast(0.0f);
+            const Pack one = Pack::broadcast(1.0f);
+            const Pack exposure = Pack::broadcast(m_exposure / reference_white);
+            const Pack color_range = Pack::broadcast(static_cast<float>(image.getColorRange()));
+            std::array<float, Pack::width> red{}, green{}, blue{}, alpha{};
+
+            for(size_t y = 0; y < buffer.height(); y++) {
+                AccumulationBuffer::Row row = buffer.row(y);
+                std::span<Color> pixels = image.row(y);
+                for(size_t x = 0; x < buffer.width(); x += Pack::width) {
+                    Pack samples = Pack::load(row.samples + x);
+                    // pixels without samples come out black rather than NaN
+                    Pack inverse = Pack::select(samples > zero, one / samples, zero);
+                    Pack scale = inverse * exposure;
+
+                    std::array<Pack, 3> channels = {Pack::load(row.red + x) * scale, Pack::load(row.green + x) * scale,
+                                                    Pack::load(row.blue + x) * scale};
+                    for(Pack& channel : channels) {
+                        channel = toneMap<tone_map_operator>(channel);
+                        if constexpr (srgb) {
+                            channel = encodeSrgb(channel);
+                        }
+                        channel = channel * color_range;
+                    }
+                    channels[0].store(red.data());
+                    channels[1].store(green.data());
+                    channels[2].store(blue.data());
+                    clamp(Pack::load(row.alpha + x) * inverse, zero, one).store(alpha.data());
+
+                    size_t lanes = std::min(Pack::width, buffer.width() - x);
+                    for(size_t lane = 0; lane < lanes; lane++) {
+                        pixels[x + lane] = Color(static_cast<double>(std::nearbyint(red[lane])),
+                                                 static_cast<double>(std::nearbyint(green[lane])),
+                                                 static_cast<double>(std::nearbyint(blue[lane])),
+                                                 static_cast<double>(alpha[lane]));
+                    }
+                }
+            }
+        }
+
+        template<ToneMapOperator tone_map_operator>
+        void applyTo(const AccumulationBuffer& buffer, Image& image) const
+        {
+            if(m_srgb) {
+                applyTo<tone_map_operator, true>(buffer, image);
+            } else {
+                applyTo<tone_map_operator, false>(buffer, image);
+            }
+        }
+
+    public:
+        ToneMapper() = default;
+        ~ToneMapper() = default;
+        ToneMapper(const ToneMapper& other) = default;
+        ToneMapper(ToneMapper&& other) noexcept = default;
+        ToneMapper& operator=(const ToneMapper& other) = default;
+        ToneMapper& operator=(ToneMapper&& other) noexcept = default;
+
+        /*!
+         * @param tone_map_operator how to bring bright colors into range
+         * @param exposure scale applied to the colors before the operator. Must be greater than 0
+         * @param srgb encode with the sRGB transfer function after tone mapping
+         */
+        ToneMapper(ToneMapOperator tone_map_operator, float exposure, bool srgb)
+            : m_operator(tone_map_operator), m_exposure(exposure), m_srgb(srgb)
+        {
+            if(exposure <= 0) {
+                throw std::invalid_argument("'exposure' must be greater than 0");
+            }
+        }
+
+        /*!
+         * Construct a tone mapper from the optional "tone_map", "exposure" and "srgb" keys of the \p output_config.
+         * Without them, colors are only clamped to display white, with no sRGB encoding.
+         * @param output_config json config for the output
+         */
+        explicit ToneMapper(const nlohmann::json& output_config)
+        {
+            ToneMapOperator tone_map_operator = ToneMapOperator::Linear;
+            float exposure = 1.0f;
+            bool srgb = false;
+            if(output_config.contains("tone_map")) {
+                tone_map_operator = ToneMapOperatorFromString(output_config.at("tone_map").get<std::string>());
+            }
+            if(output_config.contains("exposure")) {
+                exposure = output_config.at("exposure").get<float>();
+            }
+            if(output_config.contains("srgb")) {
+                srgb = output_config.at("srgb").get<bool>();
+            }
+            *this = ToneMapper(tone_map_operator, exposure, srgb);
+        }
+
+        /*!
+         * Write the tone mapped mean of every pixel of the \p buffer into the \p image, which must be the same size
+         * @param buffer the samples
+         * @param image receives colors quantized to whole numbers in [0, image.getColorRange()]
+         */
+        void apply(const AccumulationBuffer& buffer, Image& image) const
+        {
+            switch(m_operator) {
+                case ToneMapOperator::Linear:
+                    applyTo<ToneMapOperator::Linear>(buffer, image);
+                    break;
+                case ToneMapOperator::Reinhard:
+                    applyTo<ToneMapOperator::Reinhard>(buffer, image);
+                    break;
+                case ToneMapOperator::ACES:
+                    applyTo<ToneMapOperator::ACES>(buffer, image);
+                    break;
+            }
+        }
+
+        [[nodiscard]] ToneMapOperator getOperator() const { return m_operator; }
+        [[nodiscard]] float getExposure() const { return m_exposure; }
+        [[nodiscard]] bool isSrgb() const { return m_srgb; }
+    };
+}
@@ -0,0 +1,179 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+
+#include "LinearAlgebraTypeTraits.h"
+#include "Point_X.h"
+#include "Vector_X.h"
+#include "Ray.h"
+
+namespace linear_algebra_core
+{
+    /*!
+     * Axis aligned bounding box defined by its minimum and maximum corners. A default constructed box is empty, and
+     * will take on the bounds of the first point or box it is expanded by.
+     */
+    template<size_t N, IsFloatingPoint value_type>
+    class BoundingBox
+    {
+    private:
+        using Point_N = Point_X<N, value_type>;
+        using Vector_N = Vector_X<N, value_type>;
+
+        Point_N m_min;
+        Point_N m_max;
+
+    public:
+        BoundingBox()
+        {
+            std::fill(m_min.begin(), m_min.end(), std::numeric_limits<value_type>::max());
+            std::fill(m_max.begin(), m_max.end(), std::numeric_limits<value_type>::lowest());
+        }
+        ~BoundingBox() = default;
+        BoundingBox(const BoundingBox& other) = default;
+        BoundingBox(BoundingBox&& other) noexcept = default;
+        BoundingBox& operator=(const BoundingBox& other) = default;
+        BoundingBox& operator=(BoundingBox&& other) noexcept = default;
+
+        /*!
+         * Construct a bounding box from two opposite corners. The corners do not need to be ordered.
+         * @param a first corner of the box
+         * @param b second corner of the box
+         */
+        BoundingBox(const Point_N& a, const Point_N& b) : BoundingBox()
+        {
+            expand(a);
+            expand(b);
+        }
+
+        /*!
+         * @return the corner of the box with the smallest coordinates
+         */
+        [[nodiscard]] const Point_N& getMin() const { return m_min; }
+
+        /*!
+         * @return the corner of the box with the largest coordinates
+         */
+        [[nodiscard]] const Point_N& getMax() const { return m_max; }
+
+        /*!
+         * @return true if the box has not been expanded by anything yet
+         */
+        [[nodiscard]] bool isEmpty() const
+        {
+            for(size_t i = 0; i < N; i++) {
+                if(m_min[i] > m_max[i]) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /*!
+         * Grow the box so it contains \p point
+         * @param point the point to contain
+         * @return a reference to this box
+         */
+        BoundingBox& expand(const Point_N& point)
+        {
+            for(size_t i = 0; i < N; i++) {
+                m_min[i] = std::min(m_min[i], point[i]);
+                m_max[i] = std::max(m_max[i], point[i]);
+            }
+            return (*this);
+        }
+
+        /*!
+         * Grow the box so it contains \p other
+         * @param other the box to contain
+         * @return a reference to this box
+         */
+        BoundingBox& expand(const BoundingBox& other)
+        {
+            for(size_t i = 0; i < N; i++) {
+                m_min[i] = std::min(m_min[i], other.m_min[i]);
+                m_max[i] = std::max(m_max[i], other.m_max[i]);
+            }
+            return (*this);
+        }
+
+        /*!
+         * @return the vector from the minimum corner to the maximum corner
+         */
+        [[nodiscard]] Vector_N getExtent() const { return m_max - m_min; }
+
+        /*!
+         * @return the center point of the box
+         */
+        [[nodiscard]] Point_N getCenter() const { return m_min + (getExtent() * static_cast<value_type>(0.5)); }
+
+        /*!
+         * @return the index of the axis along which the box is the longest
+         */
+        [[nodiscard]] size_t getLongestAxis() const
+        {
+            Vector_N extent = getExtent();
+            return static_cast<size_t>(std::distance(extent.cbegin(), std::max_element(extent.cbegin(), extent.cend())));
+        }
+
+        /*!
+         * @return the surface area of the box, or 0 if the box is empty
+         */
+        [[nodiscard]] value_type getSurfaceArea() const requires (N == 3)
+        {
+            if(isEmpty()) {
+                return 0;
+            }
+            Vector_N extent = getExtent();
+            return 2 * ((extent[0] * extent[1]) + (extent[1] * extent[2]) + (extent[2] * extent[0]));
+        }
+
+        /*!
+         * Slab test against a ray given by its origin and the inverse of its direction. Components of
+         * \p inverse_direction may be infinite when the ray is parallel to a slab.
+         * @param origin origin of the ray
+         * @param inverse_direction per component inverse of the ray direction
+         * @param t_min smallest ray parameter to accept
+         * @param t_max largest ray parameter to accept
+         * @return the ray parameter where the ray enters the box, if it does so within [\p t_min, \p t_max]
+         */
+        [[nodiscard]] std::optional<value_type> getEntryDistance(const Point_N& origin, const Vector_N& inverse_direction,
+                                                                 value_type t_min, value_type t_max) const
+        {
+            for(size_t i = 0; i < N; i++) {
+                value_type t_near = (m_min[i] - origin[i]) * inverse_direction[i];
+                value_type t_far  = (m_max[i] - origin[i]) * inverse_direction[i];
+                if(t_near > t_far) {
+                    std::swap(t_near, t_far);
+                }
+                // written so that a NaN (origin on a slab plane of a parallel ray) leaves the interval unchanged
+                t_min = t_near > t_min ? t_near : t_min;
+                t_max = t_far  < t_max ? t_far  : t_max;
+                if(t_min > t_max) {
+                    return std::nullopt;
+                }
+            }
+            return t_min;
+        }
+
+        /*!
+         * Slab test against the given \p ray, using the inverse direction the ray precomputes.
+         * @param ray the ray to test
+         * @param t_min smallest ray parameter to accept
+         * @param t_max largest ray parameter to accept
+         * @return true if the ray passes through the box within [\p t_min, \p t_max]
+         */
+        [[nodiscard]] bool intersects(const Ray<N, value_type>& ray,
+                                      value_type t_min = 0,
+                                      value_type t_max = std::numeric_limits<value_type>::max()) const
+        {
+            return getEntryDistance(ray.getOrigin(), ray.getInverse(), t_min, t_max).has_value();
+        }
+    };
+}
@@ -3,6 +3,7 @@
 //
 #pragma once
 
+#include <limits>
 #include <type_traits>
 
 namespace linear_algebra_core {
@@ -32,6 +33,13 @@ namespace linear_algebra_core {
     template<typename T>
     concept IsFloatingPoint = std::is_floating_point_v<T>;
 
+    /*!
+     * Relative tolerance for comparing results that carry the rounding error of a handful of operations, such as the
+     * dot product of two unit vectors. Scales with the precision of \p value_type.
+     */
+    template<IsFloatingPoint value_type>
+    inline constexpr value_type relative_tolerance = std::numeric_limits<value_type>::epsilon() * 64;
+
     template<typename From, typename To>
     concept DoesNotNarrowlyConvertTo = IsArithmetic<To> && IsArithmetic<From> && detail::is_not_narrowing_conversion_v<From, To>;
 }
\ No newline at end of file
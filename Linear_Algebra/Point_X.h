@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <functional>
 #include <string>
 #include <iostream>
 #include <stdexcept>
@@ -169,9 +170,9 @@ namespace linear_algebra_core
          * @param rhs Point to be scaled
          * @return the scaled point
          */
-        template<IsArithmetic result_value_type, DoesNotNarrowlyConvertTo<result_value_type> T>
+        template<DoesNotNarrowlyConvertTo<value_type> T>
         [[nodiscard]] friend inline
-        Point_X<N, result_value_type> operator*(T scalar, const Point_X<N, result_value_type>& rhs)
+        Point_X<N, value_type> operator*(T scalar, const Point_X<N, value_type>& rhs)
         {
             return rhs * scalar;
         }
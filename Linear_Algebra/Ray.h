@@ -20,6 +20,24 @@ namespace linear_algebra_core
             m_direction{dir.getUnitVector()} ,
             m_inverse_direction{m_direction.getInverse()}
             { }
+        /*!
+         * Construct a ray from a direction that is already a unit vector and its inverse, e.g. one ray of a RayPacket,
+         * skipping the normalization and inversion done by the regular constructor.
+         * @param start origin of the ray
+         * @param unit_direction direction of the ray, which must be a unit vector
+         * @param inverse_direction per component inverse of \p unit_direction
+         * @return the ray
+         */
+        [[nodiscard]] static Ray FromUnitDirection(const Point_X<N, value_type>& start, const Vector_X<N, value_type>& unit_direction,
+                                                   const Vector_X<N, value_type>& inverse_direction)
+        {
+            Ray result;
+            result.m_origin = start;
+            result.m_direction = unit_direction;
+            result.m_inverse_direction = inverse_direction;
+            return result;
+        }
+
         ~Ray() = default;
         Ray(const Ray& other) = default;
         Ray(Ray&& other) noexcept = default;
@@ -76,7 +94,7 @@ namespace linear_algebra_core
          */
         [[maybe_unused]] void setDirection(const Vector_X<N, value_type>& new_direction) {
             m_direction = new_direction.getUnitVector();
-            m_inverse_direction = 1.0 / m_direction;
+            m_inverse_direction = m_direction.getInverse();
         }
 
         /*!
@@ -0,0 +1,54 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "LinearAlgebraTypeTraits.h"
+#include "Point_X.h"
+#include "Vector_X.h"
+#include "Ray.h"
+#include "SimdPack.h"
+
+namespace linear_algebra_core
+{
+    /*!
+     * Up to 16 rays, one per pixel of a 4x4 block, stored as a structure of arrays so a whole simd::Pack of rays can be
+     * processed at once. Ray \p lane belongs to pixel (lane % side, lane / side) of the block. Only the first
+     * \p count rays are in use, the values in the remaining lanes are meaningless but harmless.
+     */
+    template<IsFloatingPoint value_type>
+    struct RayPacket
+    {
+        static constexpr size_t side = 4;
+        static constexpr size_t size = side * side;
+        using Lanes = std::array<value_type, size>;
+        static_assert(size % simd::Pack<value_type>::width == 0, "a packet must be a whole number of simd::Packs");
+
+        // indexed by coordinate, then lane
+        alignas(64) std::array<Lanes, 3> origin{};
+        alignas(64) std::array<Lanes, 3> direction{};
+        alignas(64) std::array<Lanes, 3> inverse_direction{};
+        size_t count = 0;
+
+        /*!
+         * @return a mask with the bits of the rays in use set
+         */
+        [[nodiscard]] uint32_t getActiveRays() const { return count >= 32 ? ~0u : (1u << count) - 1; }
+
+        /*!
+         * @return the ray in \p lane
+         */
+        [[nodiscard]] Ray<3, value_type> getRay(size_t lane) const
+        {
+            return Ray<3, value_type>::FromUnitDirection(
+                    Point_X<3, value_type>(origin[0][lane], origin[1][lane], origin[2][lane]),
+                    Vector_X<3, value_type>(direction[0][lane], direction[1][lane], direction[2][lane]),
+                    Vector_X<3, value_type>(inverse_direction[0][lane], inverse_direction[1][lane], inverse_direction[2][lane]));
+        }
+    };
+}
@@ -0,0 +1,205 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#include "LinearAlgebraTypeTraits.h"
+
+#if !defined(RAY_TRACER_DISABLE_SIMD) && (defined(__AVX__) || defined(__SSE2__))
+#include <immintrin.h>
+#endif
+
+namespace linear_algebra_core::simd
+{
+    /*!
+     * A fixed number of values of \p value_type operated on together. This generic version holds a single value and is
+     * the scalar fallback; float and double are specialized below for the widest instruction set the compiler targets
+     * (8 floats / 4 doubles with AVX, 4 floats / 2 doubles with SSE2). Define RAY_TRACER_DISABLE_SIMD to always use the
+     * scalar version.
+     *
+     * Comparisons give a Mask with one lane per value. Comparisons involving NaN are false, so NaN can be used to pad
+     * lanes that should never pass a test.
+     */
+    template<IsFloatingPoint value_type>
+    struct Pack
+    {
+        struct Mask
+        {
+            bool value;
+
+            [[nodiscard]] Mask operator&(const Mask& rhs) const { return {value && rhs.value}; }
+            [[nodiscard]] Mask operator|(const Mask& rhs) const { return {value || rhs.value}; }
+            [[nodiscard]] bool any() const { return value; }
+            // bit i is set if lane i is set
+            [[nodiscard]] unsigned int bits() const { return value ? 1u : 0u; }
+        };
+
+        static constexpr size_t width = 1;
+        value_type value;
+
+        [[nodiscard]] static Pack broadcast(value_type scalar) { return {scalar}; }
+        [[nodiscard]] static Pack load(const value_type* source) { return {*source}; }
+        [[nodiscard]] static Pack laneIndices() { return {0}; }
+        [[nodiscard]] static Pack select(const Mask& mask, const Pack& if_true, const Pack& if_false) { return mask.value ? if_true : if_false; }
+        void store(value_type* destination) const { *destination = value; }
+
+        [[nodiscard]] Pack operator+(const Pack& rhs) const { return {value + rhs.value}; }
+        [[nodiscard]] Pack operator-(const Pack& rhs) const { return {value - rhs.value}; }
+        [[nodiscard]] Pack operator*(const Pack& rhs) const { return {value * rhs.value}; }
+        [[nodiscard]] Pack operator/(const Pack& rhs) const { return {value / rhs.value}; }
+        [[nodiscard]] Pack sqrt() const { return {std::sqrt(value)}; }
+
+        [[nodiscard]] Mask operator<(const Pack& rhs) const  { return {value < rhs.value}; }
+        [[nodiscard]] Mask operator<=(const Pack& rhs) const { return {value <= rhs.value}; }
+        [[nodiscard]] Mask operator>(const Pack& rhs) const  { return {value > rhs.value}; }
+        [[nodiscard]] Mask operator>=(const Pack& rhs) const { return {value >= rhs.value}; }
+    };
+
+#if !defined(RAY_TRACER_DISABLE_SIMD) && defined(__AVX__)
+    template<>
+    struct Pack<float>
+    {
+        struct Mask
+        {
+            __m256 value;
+
+            [[nodiscard]] Mask operator&(const Mask& rhs) const { return {_mm256_and_ps(value, rhs.value)}; }
+            [[nodiscard]] Mask operator|(const Mask& rhs) const { return {_mm256_or_ps(value, rhs.value)}; }
+            [[nodiscard]] bool any() const { return _mm256_movemask_ps(value) != 0; }
+            [[nodiscard]] unsigned int bits() const { return static_cast<unsigned int>(_mm256_movemask_ps(value)); }
+        };
+
+        static constexpr size_t width = 8;
+        __m256 value;
+
+        [[nodiscard]] static Pack broadcast(float scalar) { return {_mm256_set1_ps(scalar)}; }
+        [[nodiscard]] static Pack load(const float* source) { return {_mm256_loadu_ps(source)}; }
+        [[nodiscard]] static Pack laneIndices() { return {_mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7)}; }
+        [[nodiscard]] static Pack select(const Mask& mask, const Pack& if_true, const Pack& if_false) { return {_mm256_blendv_ps(if_false.value, if_true.value, mask.value)}; }
+        void store(float* destination) const { _mm256_storeu_ps(destination, value); }
+
+        [[nodiscard]] Pack operator+(const Pack& rhs) const { return {_mm256_add_ps(value, rhs.value)}; }
+        [[nodiscard]] Pack operator-(const Pack& rhs) const { return {_mm256_sub_ps(value, rhs.value)}; }
+        [[nodiscard]] Pack operator*(const Pack& rhs) const { return {_mm256_mul_ps(value, rhs.value)}; }
+        [[nodiscard]] Pack operator/(const Pack& rhs) const { return {_mm256_div_ps(value, rhs.value)}; }
+        [[nodiscard]] Pack sqrt() const { return {_mm256_sqrt_ps(value)}; }
+
+        [[nodiscard]] Mask operator<(const Pack& rhs) const  { return {_mm256_cmp_ps(value, rhs.value, _CMP_LT_OQ)}; }
+        [[nodiscard]] Mask operator<=(const Pack& rhs) const { return {_mm256_cmp_ps(value, rhs.value, _CMP_LE_OQ)}; }
+        [[nodiscard]] Mask operator>(const Pack& rhs) const  { return {_mm256_cmp_ps(value, rhs.value, _CMP_GT_OQ)}; }
+        [[nodiscard]] Mask operator>=(const Pack& rhs) const { return {_mm256_cmp_ps(value, rhs.value, _CMP_GE_OQ)}; }
+    };
+
+    template<>
+    struct Pack<double>
+    {
+        struct Mask
+        {
+            __m256d value;
+
+            [[nodiscard]] Mask operator&(const Mask& rhs) const { return {_mm256_and_pd(value, rhs.value)}; }
+            [[nodiscard]] Mask operator|(const Mask& rhs) const { return {_mm256_or_pd(value, rhs.value)}; }
+            [[nodiscard]] bool any() const { return _mm256_movemask_pd(value) != 0; }
+            [[nodiscard]] unsigned int bits() const { return static_cast<unsigned int>(_mm256_movemask_pd(value)); }
+        };
+
+        static constexpr size_t width = 4;
+        __m256d value;
+
+        [[nodiscard]] static Pack broadcast(double scalar) { return {_mm256_set1_pd(scalar)}; }
+        [[nodiscard]] static Pack load(const double* source) { return {_mm256_loadu_pd(source)}; }
+        [[nodiscard]] static Pack laneIndices() { return {_mm256_setr_pd(0, 1, 2, 3)}; }
+        [[nodiscard]] static Pack select(const Mask& mask, const Pack& if_true, const Pack& if_false) { return {_mm256_blendv_pd(if_false.value, if_true.value, mask.value)}; }
+        void store(double* destination) const { _mm256_storeu_pd(destination, value); }
+
+        [[nodiscard]] Pack operator+(const Pack& rhs) const { return {_mm256_add_pd(value, rhs.value)}; }
+        [[nodiscard]] Pack operator-(const Pack& rhs) const { return {_mm256_sub_pd(value, rhs.value)}; }
+        [[nodiscard]] Pack operator*(const Pack& rhs) const { return {_mm256_mul_pd(value, rhs.value)}; }
+        [[nodiscard]] Pack operator/(const Pack& rhs) const { return {_mm256_div_pd(value, rhs.value)}; }
+        [[nodiscard]] Pack sqrt() const { return {_mm256_sqrt_pd(value)}; }
+
+        [[nodiscard]] Mask operator<(const Pack& rhs) const  { return {_mm256_cmp_pd(value, rhs.value, _CMP_LT_OQ)}; }
+        [[nodiscard]] Mask operator<=(const Pack& rhs) const { return {_mm256_cmp_pd(value, rhs.value, _CMP_LE_OQ)}; }
+        [[nodiscard]] Mask operator>(const Pack& rhs) const  { return {_mm256_cmp_pd(value, rhs.value, _CMP_GT_OQ)}; }
+        [[nodiscard]] Mask operator>=(const Pack& rhs) const { return {_mm256_cmp_pd(value, rhs.value, _CMP_GE_OQ)}; }
+    };
+#elif !defined(RAY_TRACER_DISABLE_SIMD) && defined(__SSE2__)
+    template<>
+    struct Pack<float>
+    {
+        struct Mask
+        {
+            __m128 value;
+
+            [[nodiscard]] Mask operator&(const Mask& rhs) const { return {_mm_and_ps(value, rhs.value)}; }
+            [[nodiscard]] Mask operator|(const Mask& rhs) const { return {_mm_or_ps(value, rhs.value)}; }
+            [[nodiscard]] bool any() const { return _mm_movemask_ps(value) != 0; }
+            [[nodiscard]] unsigned int bits() const { return static_cast<unsigned int>(_mm_movemask_ps(value)); }
+        };
+
+        static constexpr size_t width = 4;
+        __m128 value;
+
+        [[nodiscard]] static Pack broadcast(float scalar) { return {_mm_set1_ps(scalar)}; }
+        [[nodiscard]] static Pack load(const float* source) { return {_mm_loadu_ps(source)}; }
+        [[nodiscard]] static Pack laneIndices() { return {_mm_setr_ps(0, 1, 2, 3)}; }
+        [[nodiscard]] static Pack select(const Mask& mask, const Pack& if_true, const Pack& if_false)
+        {
+            return {_mm_or_ps(_mm_and_ps(mask.value, if_true.value), _mm_andnot_ps(mask.value, if_false.value))};
+        }
+        void store(float* destination) const { _mm_storeu_ps(destination, value); }
+
+        [[nodiscard]] Pack operator+(const Pack& rhs) const { return {_mm_add_ps(value, rhs.value)}; }
+        [[nodiscard]] Pack operator-(const Pack& rhs) const { return {_mm_sub_ps(value, rhs.value)}; }
+        [[nodiscard]] Pack operator*(const Pack& rhs) const { return {_mm_mul_ps(value, rhs.value)}; }
+        [[nodiscard]] Pack operator/(const Pack& rhs) const { return {_mm_div_ps(value, rhs.value)}; }
+        [[nodiscard]] Pack sqrt() const { return {_mm_sqrt_ps(value)}; }
+
+        [[nodiscard]] Mask operator<(const Pack& rhs) const  { return {_mm_cmplt_ps(value, rhs.value)}; }
+        [[nodiscard]] Mask operator<=(const Pack& rhs) const { return {_mm_cmple_ps(value, rhs.value)}; }
+        [[nodiscard]] Mask operator>(const Pack& rhs) const  { return {_mm_cmpgt_ps(value, rhs.value)}; }
+        [[nodiscard]] Mask operator>=(const Pack& rhs) const { return {_mm_cmpge_ps(value, rhs.value)}; }
+    };
+
+    template<>
+    struct Pack<double>
+    {
+        struct Mask
+        {
+            __m128d value;
+
+            [[nodiscard]] Mask operator&(const Mask& rhs) const { return {_mm_and_pd(value, rhs.value)}; }
+            [[nodiscard]] Mask operator|(const Mask& rhs) const { return {_mm_or_pd(value, rhs.value)}; }
+            [[nodiscard]] bool any() const { return _mm_movemask_pd(value) != 0; }
+            [[nodiscard]] unsigned int bits() const { return static_cast<unsigned int>(_mm_movemask_pd(value)); }
+        };
+
+        static constexpr size_t width = 2;
+        __m128d value;
+
+        [[nodiscard]] static Pack broadcast(double scalar) { return {_mm_set1_pd(scalar)}; }
+        [[nodiscard]] static Pack load(const double* source) { return {_mm_loadu_pd(source)}; }
+        [[nodiscard]] static Pack laneIndices() { return {_mm_setr_pd(0, 1)}; }
+        [[nodiscard]] static Pack select(const Mask& mask, const Pack& if_true, const Pack& if_false)
+        {
+            return {_mm_or_pd(_mm_and_pd(mask.value, if_true.value), _mm_andnot_pd(mask.value, if_false.value))};
+        }
+        void store(double* destination) const { _mm_storeu_pd(destination, value); }
+
+        [[nodiscard]] Pack operator+(const Pack& rhs) const { return {_mm_add_pd(value, rhs.value)}; }
+        [[nodiscard]] Pack operator-(const Pack& rhs) const { return {_mm_sub_pd(value, rhs.value)}; }
+        [[nodiscard]] Pack operator*(const Pack& rhs) const { return {_mm_mul_pd(value, rhs.value)}; }
+        [[nodiscard]] Pack operator/(const Pack& rhs) const { return {_mm_div_pd(value, rhs.value)}; }
+        [[nodiscard]] Pack sqrt() const { return {_mm_sqrt_pd(value)}; }
+
+        [[nodiscard]] Mask operator<(const Pack& rhs) const  { return {_mm_cmplt_pd(value, rhs.value)}; }
+        [[nodiscard]] Mask operator<=(const Pack& rhs) const { return {_mm_cmple_pd(value, rhs.value)}; }
+        [[nodiscard]] Mask operator>(const Pack& rhs) const  { return {_mm_cmpgt_pd(value, rhs.value)}; }
+        [[nodiscard]] Mask operator>=(const Pack& rhs) const { return {_mm_cmpge_pd(value, rhs.value)}; }
+    };
+#endif
+}
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <functional>
 #include <string>
 #include <iosfwd>
 #include <stdexcept>
@@ -239,9 +240,9 @@ namespace linear_algebra_core
          * @param rhs vector to be scaled.
          * @return the scaled vector
          */
-        template<IsArithmetic result_value_type, DoesNotNarrowlyConvertTo<result_value_type> T>
+        template<DoesNotNarrowlyConvertTo<value_type> T>
         [[nodiscard]] friend inline
-        Vector_X<N, result_value_type> operator*(T scalar, const Vector_X<N, result_value_type>& rhs)
+        Vector_X<N, value_type> operator*(T scalar, const Vector_X<N, value_type>& rhs)
         {
             return rhs * scalar;
         }
@@ -567,7 +568,8 @@ namespace linear_algebra_core
         }
 
         /*!
-         * Checks the orthogonality of this vector and \p other.
+         * Checks the orthogonality of this vector and \p other. Floating point vectors are compared with a tolerance
+         * relative to their magnitudes, so normalized vectors that are orthogonal up to rounding error still count.
          * @param other vector to check orthogonality with
          * @return true if the vectors are orthogonal, false otherwise.
          */
@@ -575,7 +577,11 @@ namespace linear_algebra_core
         [[nodiscard]]
         inline bool isOrthogonalTo(const Vector_X<N, other_type>& other) const
         {
-            return ((*this) * other) == 0;
+            if constexpr (IsFloatingPoint<value_type>) {
+                return std::abs((*this) * other) <= relative_tolerance<value_type> * getMagnitude() * other.getMagnitude();
+            } else {
+                return ((*this) * other) == 0;
+            }
         }
 
         /*!
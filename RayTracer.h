@@ -5,27 +5,328 @@
 #include "Environment.h"
 #include "json.h"
 #include "RandomNumberGenerator.h"
+#include "TileScheduler.h"
+#include "Statistics.h"
+#include "RayPacket.h"
+#include "ThreadPool.h"
+#include "ImageWriter_I.h"
+#include "AccumulationBuffer.h"
+#include "ToneMapper.h"
+#include "AdaptiveSampling.h"
+#include "SamplerBuilder.h"
 
-#include <future>
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <optional>
 #include <string>
 #include <chrono>
+#include <concepts>
+#include <memory>
 #include <sstream>
+#include <utility>
 
 using namespace output;
 using namespace scene;
 using namespace environment;
+using namespace render;
 
 template<IsFloatingPoint value_type>
 class RayTracer
 {
 private:
     using Point_3 = Point_X<3, value_type>;
+    using Ray_3 = Ray<3, value_type>;
+    using Packet = RayPacket<value_type>;
 
+    // created before everything else, so building the environment can already run on it
+    std::unique_ptr<utility::ThreadPool> m_thread_pool;
     Environment<value_type> m_environment;
     Scene<value_type>       m_scene;
     Image       m_image;
     size_t      m_samples_per_pixel;
-    size_t      m_num_threads;
+    uint64_t    m_seed;
+    size_t      m_tile_size = 16;
+    TileOrder   m_tile_order = TileOrder::Morton;
+    utility::RenderStatistics  m_statistics;
+    // where to write the statistics of each render as json, if anywhere
+    std::optional<std::string> m_statistics_file;
+    // trace primary rays in packets of neighbouring pixels rather than one at a time
+    bool        m_ray_packets = true;
+
+    // every sample is summed up here, and tone mapped into m_image once the samples are in
+    AccumulationBuffer m_accumulation;
+    ToneMapper  m_tone_mapper;
+
+    // render one sample per pixel per pass, publishing the image after every pass
+    bool        m_progressive = false;
+    // how long a progressive render may take, if limited
+    std::optional<std::chrono::nanoseconds> m_time_budget;
+    std::optional<std::chrono::steady_clock::time_point> m_deadline;
+    std::atomic<bool> m_cancelled{false};
+    std::function<void(const Image&, size_t)> m_pass_callback;
+    size_t      m_completed_passes = 0;
+
+    // stop sampling pixels once their estimated error is small enough, if set. samples_per_pixel is then the cap
+    std::optional<AdaptiveSampling> m_adaptive;
+    // the luminance estimate of every pixel, row by row, when sampling adaptively
+    std::vector<RunningVariance> m_pixel_estimates;
+    // the number of primary rays the last call to trace traced
+    size_t      m_samples_taken = 0;
+    // where in each pixel its samples go
+    std::unique_ptr<Sampler_I<value_type>> m_sampler;
+
+    /*!
+     * @return the color seen along the \p ray, given its closest \p hit
+     */
+    [[nodiscard]] Color shade(const Ray_3& ray, const std::optional<HitRecord<value_type>>& hit) const
+    {
+        if(!hit.has_value())
+        {
+            utility::count(utility::Counter::BackgroundMisses);
+            return m_environment.getBackgroundColor(ray);
+        }
+
+        utility::count(utility::Counter::Hits);
+        const Color white(255, 255, 255);
+        Color shape_color = hit->geometry->getColorAt(hit->point);
+        // the ray direction is already a unit vector
+        value_type t = ray.getDirection() * hit->normal;
+        return Color::blend(white, shape_color, std::clamp(t, static_cast<value_type>(0.0), static_cast<value_type>(1.0)));
+    }
+
+    /*!
+     * Which samples of each pixel a call to traceTile or tracePacketTile takes
+     */
+    struct SampleRange
+    {
+        size_t first = 0;
+        size_t count = 0;
+    };
+
+    /*!
+     * Add the sum of the \p taken samples of the pixel at \p x, \p y to the accumulation buffer
+     */
+    void storePixel(size_t x, size_t y, const Color& color, size_t taken)
+    {
+        if(taken > 0) {
+            m_accumulation.add(x, y, color, static_cast<uint32_t>(taken));
+        }
+    }
+
+    /*!
+     * @return the luminance estimate of the pixel at \p x, \p y, or nullptr if not sampling adaptively
+     */
+    [[nodiscard]] RunningVariance* getEstimate(size_t x, size_t y)
+    {
+        return m_adaptive.has_value() ? &m_pixel_estimates[(y * m_image.width()) + x] : nullptr;
+    }
+
+    /*!
+     * @return true if the pixel with the \p estimate needs no more samples. Never when not sampling adaptively
+     */
+    [[nodiscard]] bool isConverged(const RunningVariance* estimate) const
+    {
+        return estimate != nullptr && m_adaptive->isConverged(*estimate);
+    }
+
+    /*!
+     * @return true once the render should stop early, because it was cancelled or ran out of time
+     */
+    [[nodiscard]] bool shouldStop() const
+    {
+        if(m_cancelled.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        return m_deadline.has_value() && std::chrono::steady_clock::now() >= *m_deadline;
+    }
+
+    /*!
+     * @return the point \p offset of the way across [\p low, \p low + \p step), computed the same way as
+     * RandomStream::uniform(low, high)
+     */
+    [[nodiscard]] static value_type jitter(value_type low, value_type step, value_type offset)
+    {
+        return low + (((low + step) - low) * offset);
+    }
+
+    /*!
+     * Trace every pixel of the \p tile one ray at a time
+     * @return the number of samples taken
+     */
+    size_t traceTile(const Tile& tile, value_type x_step, value_type y_step, const SampleRange& samples)
+    {
+        size_t tile_samples = 0;
+        for(size_t j = tile.y; j < tile.y + tile.height; j++)
+        {
+            value_type v = j * y_step;
+
+            for(size_t i = tile.x; i < tile.x + tile.width; i++)
+            {
+                value_type u = i * x_step;
+                Color pixelColor{};
+                RunningVariance* estimate = getEstimate(i, j);
+
+                size_t taken = 0;
+                for(; taken < samples.count && !isConverged(estimate); taken++)
+                {
+                    std::array<value_type, 2> offset = m_sampler->get(i, j, samples.first + taken);
+                    Ray_3 ray = m_scene.getRayFor(jitter(u, x_step, offset[0]), jitter(v, y_step, offset[1]));
+                    utility::count(utility::Counter::PrimaryRays);
+                    Color sample = shade(ray, m_environment.getClosestHit(ray));
+                    if(estimate != nullptr) {
+                        estimate->add(luminance(sample));
+                    }
+                    pixelColor += sample;
+                }
+
+                storePixel(i, j, pixelColor, taken);
+                tile_samples += taken;
+            }
+        }
+        return tile_samples;
+    }
+
+    /*!
+     * Trace the pixels of the \p tile in blocks of RayPacket::side x RayPacket::side, one packet per sample. Each pixel
+     * gets the same samples from the sampler as in traceTile, so the image is the same. Pixels
+     * that have converged drop out, and the ones left are packed into the first lanes of the next packet.
+     * @return the number of samples taken
+     */
+    size_t tracePacketTile(const Tile& tile, value_type x_step, value_type y_step, const SampleRange& samples)
+    {
+        size_t tile_samples = 0;
+        for(size_t block_y = tile.y; block_y < tile.y + tile.height; block_y += Packet::side)
+        {
+            size_t block_height = std::min(Packet::side, tile.y + tile.height - block_y);
+            for(size_t block_x = tile.x; block_x < tile.x + tile.width; block_x += Packet::side)
+            {
+                size_t block_width = std::min(Packet::side, tile.x + tile.width - block_x);
+                size_t count = block_width * block_height;
+
+                // lanes are filled in row by row over the pixels of the block that are inside the tile
+                std::array<size_t, Packet::size> pixel_x{}, pixel_y{};
+                std::array<Color, Packet::size> pixel_colors{};
+                std::array<RunningVariance*, Packet::size> estimates{};
+                std::array<size_t, Packet::size> taken{};
+                // the pixels still being sampled, by their index in the block
+                std::array<size_t, Packet::size> active{};
+                size_t active_count = 0;
+                for(size_t lane = 0; lane < count; lane++) {
+                    pixel_x[lane] = block_x + (lane % block_width);
+                    pixel_y[lane] = block_y + (lane / block_width);
+                    estimates[lane] = getEstimate(pixel_x[lane], pixel_y[lane]);
+                    if(!isConverged(estimates[lane])) {
+                        active[active_count++] = lane;
+                    }
+                }
+
+                Packet packet;
+                typename Packet::Lanes sample_u{}, sample_v{};
+                std::array<std::optional<HitRecord<value_type>>, Packet::size> hits;
+                for(size_t _ = 0; _ < samples.count && active_count > 0; _++)
+                {
+                    for(size_t lane = 0; lane < active_count; lane++) {
+                        size_t pixel = active[lane];
+                        value_type u = pixel_x[pixel] * x_step;
+                        value_type v = pixel_y[pixel] * y_step;
+                        std::array<value_type, 2> offset = m_sampler->get(pixel_x[pixel], pixel_y[pixel], samples.first + taken[pixel]);
+                        sample_u[lane] = jitter(u, x_step, offset[0]);
+                        sample_v[lane] = jitter(v, y_step, offset[1]);
+                    }
+                    m_scene.getRayPacketFor(sample_u, sample_v, active_count, packet);
+                    utility::count(utility::Counter::PrimaryRays, active_count);
+                    m_environment.getClosestHits(packet, hits);
+
+                    size_t still_active = 0;
+                    for(size_t lane = 0; lane < active_count; lane++) {
+                        size_t pixel = active[lane];
+                        Color sample = shade(packet.getRay(lane), hits[lane]);
+                        if(estimates[pixel] != nullptr) {
+                            estimates[pixel]->add(luminance(sample));
+                        }
+                        pixel_colors[pixel] += sample;
+                        taken[pixel]++;
+                        if(!isConverged(estimates[pixel])) {
+                            active[still_active++] = pixel;
+                        }
+                    }
+                    active_count = still_active;
+                }
+
+                for(size_t lane = 0; lane < count; lane++) {
+                    storePixel(pixel_x[lane], pixel_y[lane], pixel_colors[lane], taken[lane]);
+                    tile_samples += taken[lane];
+                }
+            }
+        }
+        return tile_samples;
+    }
+
+    /*!
+     * @return the worker pool described by the "number_of_threads" and "pin_threads" ray tracer parameters
+     */
+    [[nodiscard]] static std::unique_ptr<utility::ThreadPool> CreateThreadPool(const nlohmann::json& ray_tracer_parameters)
+    {
+        auto num_threads = ray_tracer_parameters.at("number_of_threads").get<int>();
+        size_t thread_count = num_threads <= 0 ? std::thread::hardware_concurrency() : static_cast<size_t>(num_threads);
+        bool pin_threads = false;
+        if(ray_tracer_parameters.contains("pin_threads")) {
+            pin_threads = ray_tracer_parameters.at("pin_threads").get<bool>();
+        }
+        return std::make_unique<utility::ThreadPool>(thread_count, pin_threads);
+    }
+
+    /*!
+     * @return the environment made by \p load_environment, with any parallel work it does running on the \p pool
+     */
+    template<std::invocable EnvironmentLoader>
+    [[nodiscard]] static Environment<value_type> LoadOn(utility::ThreadPool& pool, EnvironmentLoader& load_environment)
+    {
+        utility::ThreadPool::Scope scope(pool);
+        return load_environment();
+    }
+    /*!
+     * Trace the \p samples of every pixel on the worker pool, adding each worker's counters to \p thread_statistics
+     * and the number of samples taken to m_samples_taken
+     * @return false if the pass stopped early, leaving some tiles without the samples
+     */
+    bool tracePass(const SampleRange& samples, std::vector<utility::ThreadStatistics>& thread_statistics)
+    {
+        value_type x_step = static_cast<value_type>(1.0) / static_cast<value_type>(m_image.width());
+        value_type y_step = static_cast<value_type>(1.0) / static_cast<value_type>(m_image.height());
+
+        size_t thread_count = m_thread_pool->size();
+        TileScheduler scheduler(m_image.width(), m_image.height(), m_tile_size, m_tile_order, thread_count);
+        std::atomic<bool> stopped{false};
+        std::atomic<size_t> samples_taken{0};
+        m_thread_pool->run(thread_count, [&](size_t thread_num)
+        {
+            size_t thread_samples = 0;
+            while(std::optional<Tile> tile = scheduler.next(thread_num))
+            {
+                if(shouldStop()) {
+                    stopped = true;
+                    break;
+                }
+                auto tile_start = utility::statistics_enabled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+                if(m_ray_packets) {
+                    thread_samples += tracePacketTile(*tile, x_step, y_step, samples);
+                } else {
+                    thread_samples += traceTile(*tile, x_step, y_step, samples);
+                }
+                if constexpr (utility::statistics_enabled) {
+                    utility::addBusyTime(std::chrono::steady_clock::now() - tile_start);
+                }
+            }
+            thread_statistics[thread_num] += utility::takeThreadStatistics();
+            samples_taken += thread_samples;
+        });
+        m_samples_taken += samples_taken;
+        return !stopped;
+    }
+
 public:
 
     /*!
@@ -37,72 +338,200 @@ public:
      */
     RayTracer(const nlohmann::json& environment_config, const nlohmann::json& scene_config,
               const nlohmann::json& output_config, const nlohmann::json& ray_tracer_parameters)
-            : m_environment(environment_config), m_scene(scene_config), m_image(output_config)
+            : RayTracer([&environment_config]() { return Environment<value_type>(environment_config); },
+                        scene_config, output_config, ray_tracer_parameters)
+    {
+    }
+
+    /*!
+     * Construct the ray tracer around an environment that has already been loaded
+     * @param environment the environment to trace
+     * @param scene_config json config for the scene
+     * @param output_config json config for the output
+     * @param ray_tracer_parameters json config for the ray tracer parameters
+     */
+    RayTracer(Environment<value_type> environment, const nlohmann::json& scene_config,
+              const nlohmann::json& output_config, const nlohmann::json& ray_tracer_parameters)
+            : RayTracer([&environment]() { return std::move(environment); },
+                        scene_config, output_config, ray_tracer_parameters)
+    {
+    }
+
+    /*!
+     * Construct the ray tracer, building its environment on the ray tracer's own worker pool, e.g. from the scene cache
+     * @param load_environment called once to make the environment to trace
+     * @param scene_config json config for the scene
+     * @param output_config json config for the output
+     * @param ray_tracer_parameters json config for the ray tracer parameters
+     */
+    template<std::invocable EnvironmentLoader>
+    requires std::convertible_to<std::invoke_result_t<EnvironmentLoader>, Environment<value_type>>
+    RayTracer(EnvironmentLoader&& load_environment, const nlohmann::json& scene_config,
+              const nlohmann::json& output_config, const nlohmann::json& ray_tracer_parameters)
+            : m_thread_pool(CreateThreadPool(ray_tracer_parameters)),
+              m_environment(LoadOn(*m_thread_pool, load_environment)), m_scene(scene_config), m_image(output_config),
+              m_tone_mapper(output_config)
     {
         m_samples_per_pixel = ray_tracer_parameters.at("samples_per_pixel");
-        auto num_threads = ray_tracer_parameters.at("number_of_threads").get<int>();
-        if(num_threads <= 0) {
-            m_num_threads = std::thread::hardware_concurrency();
+        // an explicit seed makes renders reproducible, regardless of the number of threads
+        if(ray_tracer_parameters.contains("seed")) {
+            m_seed = ray_tracer_parameters.at("seed").get<uint64_t>();
         } else {
-            m_num_threads = num_threads;
+            m_seed = utility::get_randomizer_seed();
+        }
+        if(ray_tracer_parameters.contains("tile_size")) {
+            auto tile_size = ray_tracer_parameters.at("tile_size").get<int>();
+            if(tile_size <= 0) {
+                throw std::invalid_argument("'tile_size' must be greater than 0");
+            }
+            m_tile_size = tile_size;
+        }
+        if(ray_tracer_parameters.contains("tile_order")) {
+            m_tile_order = TileOrderFromString(ray_tracer_parameters.at("tile_order").get<std::string>());
+        }
+        if(ray_tracer_parameters.contains("statistics_file")) {
+            m_statistics_file = ray_tracer_parameters.at("statistics_file").get<std::string>();
+        }
+        if(ray_tracer_parameters.contains("ray_packets")) {
+            m_ray_packets = ray_tracer_parameters.at("ray_packets").get<bool>();
+        }
+        if(ray_tracer_parameters.contains("progressive")) {
+            m_progressive = ray_tracer_parameters.at("progressive").get<bool>();
+        }
+        SamplerType sampler_type = SamplerType::Random;
+        if(ray_tracer_parameters.contains("sampler")) {
+            sampler_type = SamplerTypeFromString(ray_tracer_parameters.at("sampler").get<std::string>());
+        }
+        m_sampler = CreateSampler<value_type>(sampler_type, m_seed, m_image.width(), m_samples_per_pixel);
+        if(ray_tracer_parameters.contains("adaptive_error_threshold")) {
+            size_t min_samples = AdaptiveSampling().min_samples;
+            if(ray_tracer_parameters.contains("adaptive_min_samples")) {
+                min_samples = ray_tracer_parameters.at("adaptive_min_samples").get<size_t>();
+            }
+            m_adaptive = AdaptiveSampling(ray_tracer_parameters.at("adaptive_error_threshold").get<double>(), min_samples);
+        }
+        if(ray_tracer_parameters.contains("time_budget_seconds")) {
+            auto time_budget = ray_tracer_parameters.at("time_budget_seconds").get<double>();
+            if(time_budget <= 0) {
+                throw std::invalid_argument("'time_budget_seconds' must be greater than 0");
+            }
+            m_time_budget = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(time_budget));
         }
     }
 
     /*!
-     * Run the ray tracing algorithm with the current scene and environment, placing the result in the current image object
+     * Run the ray tracing algorithm with the current scene and environment, placing the result in the current image object.
+     * Unless statistics are compiled out, a summary of the render statistics is printed afterwards, and written as json
+     * to the "statistics_file" if one was configured.
+     *
+     * With the "progressive" parameter set, each pixel gets one sample per pass, and the image and pass callback are
+     * updated after every pass. The render stops after "samples_per_pixel" passes, once "time_budget_seconds" have
+     * passed, or when cancel is called, whichever comes first.
+     *
+     * With "adaptive_error_threshold" set, a pixel stops getting samples once the standard error of its mean luminance
+     * is below the threshold, after at least "adaptive_min_samples". "samples_per_pixel" is then only the cap.
      */
     void trace()
     {
-        value_type x_step = 1.0 / static_cast<value_type>(m_image.width());
-        value_type y_step = 1.0 / static_cast<value_type>(m_image.height());
-        value_type per_pixel_fraction = 1.0 / static_cast<value_type>(m_samples_per_pixel);
-        const Color white(255, 255, 255);
+        m_cancelled = false;
+        m_deadline.reset();
+        auto render_start = std::chrono::steady_clock::now();
+        std::vector<utility::ThreadStatistics> thread_statistics(m_thread_pool->size());
+        m_samples_taken = 0;
+        if(m_adaptive.has_value()) {
+            m_pixel_estimates.assign(m_image.width() * m_image.height(), RunningVariance());
+        }
+        m_accumulation = AccumulationBuffer(m_image.width(), m_image.height());
 
-        std::vector<std::future<void>> thread_results(m_num_threads);
-        for(int current_index = 0; current_index < m_num_threads; current_index++) {
-            thread_results[current_index] = std::async(std::launch::async,
-               [this, x_step, y_step, white, per_pixel_fraction, thread_num = current_index]()
-               {
-                   for(int j = thread_num; j < m_image.height(); j += static_cast<int>(m_num_threads))
-                   {
-                       value_type v = j * y_step;
-
-                       for(int i = 0; i < m_image.width(); i++)
-                       {
-                           value_type u = i * x_step;
-                           Color pixelColor{};
-
-                           for(int _ = 0; _ < m_samples_per_pixel; _++)
-                           {
-                               value_type random_u = utility::get_random_number(u, u + x_step);
-                               value_type random_v = utility::get_random_number(v, v + y_step);
-                               Ray ray = m_scene.getRayFor(random_u, random_v);
-                               std::shared_ptr<Geometry<value_type>> intersecting_geometry = m_environment.getFirstIntersectedGeometry(ray);
-
-                               if(intersecting_geometry == nullptr)
-                               {
-                                   pixelColor += m_environment.getBackgroundColor(ray) * per_pixel_fraction;
-                                   continue;
-                               }
-
-                               std::optional<Point_3> intersection_point = intersecting_geometry->getIntersectionPoint(ray);
-                               Color shape_color = intersecting_geometry->getColorAt(intersection_point.value());
-                               value_type t = ray.getDirection().getUnitVector() * intersecting_geometry->getNormalAt(intersection_point.value());
-                               pixelColor += Color::blend(white, shape_color,
-                                                          std::clamp(t, static_cast<value_type>(0.0), static_cast<value_type>(1.0))) * per_pixel_fraction;
-                           }
-
-                           m_image.at(i, j) = pixelColor;
-                       }
-                   }
-               });
-        }
-
-        for(int i = 0; i < m_num_threads; i++) {
-            thread_results[i].get();
+        if(m_progressive) {
+            if(m_time_budget.has_value()) {
+                m_deadline = render_start + *m_time_budget;
+            }
+            m_completed_passes = 0;
+            while(m_completed_passes < m_samples_per_pixel && !shouldStop()) {
+                size_t samples_before = m_samples_taken;
+                bool finished = tracePass({m_completed_passes, 1}, thread_statistics);
+                if(finished && m_samples_taken == samples_before) {
+                    // every pixel has converged
+                    break;
+                }
+                m_tone_mapper.apply(m_accumulation, m_image);
+                if(!finished) {
+                    break;
+                }
+                m_completed_passes++;
+                if(m_pass_callback) {
+                    m_pass_callback(m_image, m_completed_passes);
+                }
+            }
+        } else {
+            tracePass({0, m_samples_per_pixel}, thread_statistics);
+            m_tone_mapper.apply(m_accumulation, m_image);
+        }
+        m_statistics = utility::RenderStatistics(std::move(thread_statistics), std::chrono::steady_clock::now() - render_start);
+
+        if constexpr (utility::statistics_enabled) {
+            std::cout << m_statistics.getSummary() << m_thread_pool->getSummary();
+            if(m_progressive) {
+                std::cout << "  progressive passes: " << m_completed_passes << " of " << m_samples_per_pixel << "\n";
+            }
+            if(m_adaptive.has_value()) {
+                double pixels = std::max<double>(static_cast<double>(m_image.width() * m_image.height()), 1.0);
+                std::cout << "  adaptive sampling:  " << static_cast<double>(m_samples_taken) / pixels
+                          << " samples per pixel on average, of at most " << m_samples_per_pixel << "\n";
+            }
+            if(m_statistics_file.has_value()) {
+                nlohmann::json statistics_json = m_statistics.toJson();
+                statistics_json["thread_pool"] = m_thread_pool->toJson();
+                std::ofstream statistics_file(m_statistics_file.value());
+                statistics_file << statistics_json.dump(4) << std::endl;
+            }
         }
     }
 
+    /*!
+     * Stop the current call to trace as soon as the tiles already being rendered are done. Safe to call from
+     * any thread. A progressive render keeps the samples of its finished tiles.
+     */
+    void cancel() { m_cancelled = true; }
+
+    /*!
+     * Call \p callback with the image and the number of completed passes after every pass of a progressive render.
+     * The callback runs on the thread that called trace, between passes.
+     */
+    void setPassCallback(std::function<void(const Image&, size_t)> callback) { m_pass_callback = std::move(callback); }
+
+    /*!
+     * @return the number of samples, i.e. primary rays, the last call to trace took over all pixels
+     */
+    [[nodiscard]] size_t getSamplesTaken() const { return m_samples_taken; }
+
+    /*!
+     * @return the number of passes the last progressive render finished
+     */
+    [[nodiscard]] size_t getCompletedPasses() const { return m_completed_passes; }
+
+    /*!
+     * Write the current image with the \p writer, encoding on the ray tracer's worker pool
+     * @param writer the writer for the image format
+     * @param filepath where to write the image
+     */
+    void writeImage(ImageWriter_I& writer, const std::string& filepath)
+    {
+        utility::ThreadPool::Scope scope(*m_thread_pool);
+        writer.write(m_image, filepath);
+    }
+
+    /*!
+     * @return the worker pool shared by tracing, image encoding and building the environment
+     */
+    [[nodiscard]] utility::ThreadPool& getThreadPool() { return *m_thread_pool; }
+
+    /*!
+     * @return the statistics of the last call to trace. Empty if statistics are compiled out
+     */
+    [[nodiscard]] const utility::RenderStatistics& getStatistics() const { return m_statistics; }
+
     [[nodiscard]] const Image& getImage() { return m_image; }
     [[nodiscard]] Image getImage() const  { return m_image; }
 
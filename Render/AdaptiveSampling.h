@@ -0,0 +1,89 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+#include "Color.h"
+
+namespace render
+{
+    /*!
+     * Running mean and variance of a pixel's samples, using Welford's algorithm so it stays accurate over many samples
+     */
+    struct RunningVariance
+    {
+        size_t count = 0;
+        double mean = 0;
+        // sum of squared differences from the mean
+        double m2 = 0;
+
+        void add(double value)
+        {
+            count++;
+            double delta = value - mean;
+            mean += delta / static_cast<double>(count);
+            m2 += delta * (value - mean);
+        }
+
+        /*!
+         * @return the unbiased sample variance, 0 with fewer than 2 samples
+         */
+        [[nodiscard]] double variance() const { return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0; }
+
+        /*!
+         * @return the estimated standard error of the mean
+         */
+        [[nodiscard]] double standardError() const { return count > 0 ? std::sqrt(variance() / static_cast<double>(count)) : 0.0; }
+    };
+
+    /*!
+     * @return the relative luminance of the \p color (Rec. 709 weights), in the color's own units
+     */
+    [[nodiscard]] inline double luminance(const color_core::Color& color)
+    {
+        const std::array<double, 4>& rgba = color.rgba();
+        return (0.2126 * rgba[0]) + (0.7152 * rgba[1]) + (0.0722 * rgba[2]);
+    }
+
+    /*!
+     * When a pixel has had enough samples: once the standard error of its mean luminance is at most error_threshold,
+     * after at least min_samples. The cap on samples is the ray tracer's samples_per_pixel.
+     */
+    struct AdaptiveSampling
+    {
+        // in the units of the image's colors, so 0.5 is half of one step of an 8 bit image with a color range of 255
+        double error_threshold = 0.5;
+        // the variance estimate is meaningless with too few samples, e.g. when they all happen to hit the same thing
+        size_t min_samples = 4;
+
+        AdaptiveSampling() = default;
+
+        /*!
+         * @param error_threshold the largest acceptable standard error. Must be greater than 0
+         * @param min_samples the number of samples every pixel gets. Must be at least 2
+         */
+        AdaptiveSampling(double error_threshold, size_t min_samples) : error_threshold(error_threshold), min_samples(min_samples)
+        {
+            if(error_threshold <= 0) {
+                throw std::invalid_argument("'adaptive_error_threshold' must be greater than 0");
+            }
+            if(min_samples < 2) {
+                throw std::invalid_argument("'adaptive_min_samples' must be at least 2");
+            }
+        }
+
+        /*!
+         * @return true once the pixel with the \p estimate needs no more samples
+         */
+        [[nodiscard]] bool isConverged(const RunningVariance& estimate) const
+        {
+            return estimate.count >= min_samples && estimate.standardError() <= error_threshold;
+        }
+    };
+}
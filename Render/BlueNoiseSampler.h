@@ -0,0 +1,197 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Sampler_I.h"
+#include "RandomNumberGenerator.h"
+
+namespace render
+{
+    /*!
+     * A rank 1 lattice sequence (R2) whose points are shifted per pixel by a tile of blue noise. Each pixel's samples
+     * are still well spread, and the error left in neighbouring pixels is decorrelated, so it shows up as fine grained
+     * noise that is much less visible than white noise at the same sample count.
+     *
+     * The two blue noise masks, one per dimension, are made once when the sampler is built with the void and cluster
+     * method, and tiled over the image with an offset chosen by the seed.
+     * @details see "The void-and-cluster method for dither array generation" (Ulichney, 1993), and "Distributing Monte
+     * Carlo Errors as a Blue Noise in Screen Space by Permuting Pixel Seeds Between Frames" (Heitz and Belcour, 2019)
+     */
+    template<linear_algebra_core::IsFloatingPoint value_type>
+    class BlueNoiseSampler : public Sampler_I<value_type>
+    {
+    public:
+        static constexpr size_t tile_size = 64;
+
+    private:
+        static constexpr size_t tile_area = tile_size * tile_size;
+        // the R2 sequence, from the plastic number
+        static constexpr double r2_u = 0.7548776662466927;
+        static constexpr double r2_v = 0.5698402909980532;
+
+        std::vector<double> m_mask_u;
+        std::vector<double> m_mask_v;
+        size_t m_shift_x;
+        size_t m_shift_y;
+
+        /*!
+         * Toroidal gaussian energy of each cell with respect to the set cells of a binary pattern
+         */
+        class EnergyField
+        {
+        private:
+            std::array<double, tile_area> m_kernel{};
+            std::vector<double> m_energy = std::vector<double>(tile_area, 0.0);
+
+        public:
+            std::vector<bool> pattern = std::vector<bool>(tile_area, false);
+
+            EnergyField()
+            {
+                constexpr double sigma = 1.5;
+                for(size_t dy = 0; dy < tile_size; dy++) {
+                    for(size_t dx = 0; dx < tile_size; dx++) {
+                        auto wrapped_x = static_cast<double>(std::min(dx, tile_size - dx));
+                        auto wrapped_y = static_cast<double>(std::min(dy, tile_size - dy));
+                        m_kernel[(dy * tile_size) + dx] = std::exp(-((wrapped_x * wrapped_x) + (wrapped_y * wrapped_y)) / (2 * sigma * sigma));
+                    }
+                }
+            }
+
+            /*!
+             * Set or clear the \p cell of the pattern, updating the energy of every cell
+             */
+            void set(size_t cell, bool value)
+            {
+                pattern[cell] = value;
+                double sign = value ? 1.0 : -1.0;
+                size_t cell_x = cell % tile_size;
+                size_t cell_y = cell / tile_size;
+                for(size_t y = 0; y < tile_size; y++) {
+                    size_t dy = (y + tile_size - cell_y) % tile_size;
+                    for(size_t x = 0; x < tile_size; x++) {
+                        size_t dx = (x + tile_size - cell_x) % tile_size;
+                        m_energy[(y * tile_size) + x] += sign * m_kernel[(dy * tile_size) + dx];
+                    }
+                }
+            }
+
+            /*!
+             * @return the set cell with the highest energy
+             */
+            [[nodiscard]] size_t tightestCluster() const
+            {
+                size_t best = 0;
+                double best_energy = -std::numeric_limits<double>::infinity();
+                for(size_t cell = 0; cell < tile_area; cell++) {
+                    if(pattern[cell] && m_energy[cell] > best_energy) {
+                        best = cell;
+                        best_energy = m_energy[cell];
+                    }
+                }
+                return best;
+            }
+
+            /*!
+             * @return the clear cell with the lowest energy
+             */
+            [[nodiscard]] size_t largestVoid() const
+            {
+                size_t best = 0;
+                double best_energy = std::numeric_limits<double>::infinity();
+                for(size_t cell = 0; cell < tile_area; cell++) {
+                    if(!pattern[cell] && m_energy[cell] < best_energy) {
+                        best = cell;
+                        best_energy = m_energy[cell];
+                    }
+                }
+                return best;
+            }
+        };
+
+        /*!
+         * @return a blue noise mask of tile_size x tile_size values in (0, 1), row by row, each value used once
+         */
+        [[nodiscard]] static std::vector<double> makeMask(uint64_t seed)
+        {
+            // start from a random pattern covering a tenth of the cells, and spread it out evenly
+            EnergyField prototype;
+            utility::RandomStream random(seed, 0);
+            size_t initial_count = tile_area / 10;
+            for(size_t placed = 0; placed < initial_count;) {
+                size_t cell = random.next32() % tile_area;
+                if(!prototype.pattern[cell]) {
+                    prototype.set(cell, true);
+                    placed++;
+                }
+            }
+            // always converges in practice, the bound is only a safeguard
+            for(size_t step = 0; step < tile_area; step++) {
+                size_t cluster = prototype.tightestCluster();
+                prototype.set(cluster, false);
+                size_t gap = prototype.largestVoid();
+                prototype.set(gap, true);
+                if(gap == cluster) {
+                    break;
+                }
+            }
+
+            std::vector<size_t> ranks(tile_area, 0);
+            // rank the initial points by removing the tightest cluster first
+            EnergyField field = prototype;
+            for(size_t rank = initial_count; rank-- > 0;) {
+                size_t cluster = field.tightestCluster();
+                field.set(cluster, false);
+                ranks[cluster] = rank;
+            }
+            // then rank the rest by filling in the largest void first
+            field = prototype;
+            for(size_t rank = initial_count; rank < tile_area; rank++) {
+                size_t gap = field.largestVoid();
+                field.set(gap, true);
+                ranks[gap] = rank;
+            }
+
+            std::vector<double> mask(tile_area);
+            for(size_t cell = 0; cell < tile_area; cell++) {
+                mask[cell] = (static_cast<double>(ranks[cell]) + 0.5) / static_cast<double>(tile_area);
+            }
+            return mask;
+        }
+
+        [[nodiscard]] static value_type wrap(double value)
+        {
+            auto result = static_cast<value_type>(value - std::floor(value));
+            // rounding to value_type can reach 1
+            return std::min(result, std::nextafter(static_cast<value_type>(1), static_cast<value_type>(0)));
+        }
+
+    public:
+        /*!
+         * Build the blue noise masks, which takes around a tenth of a second
+         * @param seed seed of the render, which picks where the tiles start
+         */
+        explicit BlueNoiseSampler(uint64_t seed)
+            : m_mask_u(makeMask(0x5EED0001)), m_mask_v(makeMask(0x5EED0002)),
+              m_shift_x(detail::hash(seed, 0) % tile_size), m_shift_y(detail::hash(seed, 1) % tile_size)
+        {
+        }
+
+        [[nodiscard]] std::array<value_type, 2> get(size_t x, size_t y, size_t sample) const override
+        {
+            size_t cell = (((y + m_shift_y) % tile_size) * tile_size) + ((x + m_shift_x) % tile_size);
+            auto index = static_cast<double>(sample);
+            return {wrap(m_mask_u[cell] + (index * r2_u)), wrap(m_mask_v[cell] + (index * r2_v))};
+        }
+    };
+}
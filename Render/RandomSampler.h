@@ -0,0 +1,41 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Sampler_I.h"
+#include "RandomNumberGenerator.h"
+
+namespace render
+{
+    /*!
+     * Independent uniform samples (white noise), drawn from a RandomStream per pixel
+     */
+    template<linear_algebra_core::IsFloatingPoint value_type>
+    class RandomSampler : public Sampler_I<value_type>
+    {
+    private:
+        uint64_t m_seed;
+        size_t m_width;
+
+    public:
+        /*!
+         * @param seed seed of the render
+         * @param width width of the image, to number the pixels
+         */
+        RandomSampler(uint64_t seed, size_t width) : m_seed(seed), m_width(width) { }
+
+        [[nodiscard]] std::array<value_type, 2> get(size_t x, size_t y, size_t sample) const override
+        {
+            utility::RandomStream random(m_seed, (static_cast<uint64_t>(y) * m_width) + x);
+            random.discardUniforms<value_type>(2 * sample);
+            value_type u = random.uniform<value_type>();
+            return {u, random.uniform<value_type>()};
+        }
+    };
+}
@@ -0,0 +1,69 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "Sampler_I.h"
+#include "RandomSampler.h"
+#include "StratifiedSampler.h"
+#include "SobolSampler.h"
+#include "BlueNoiseSampler.h"
+
+namespace render
+{
+    enum class SamplerType
+    {
+        Random,
+        Stratified,
+        Sobol,
+        BlueNoise
+    };
+
+    /*!
+     * @param sampler_name one of "random", "stratified", "sobol" or "blue_noise"
+     * @return the corresponding SamplerType
+     */
+    [[nodiscard]] inline SamplerType SamplerTypeFromString(const std::string& sampler_name)
+    {
+        if(sampler_name == "random") {
+            return SamplerType::Random;
+        } else if(sampler_name == "stratified") {
+            return SamplerType::Stratified;
+        } else if(sampler_name == "sobol") {
+            return SamplerType::Sobol;
+        } else if(sampler_name == "blue_noise") {
+            return SamplerType::BlueNoise;
+        }
+        throw std::invalid_argument("sampler must be one of the following values: \n [random, stratified, sobol, blue_noise]. got " + sampler_name);
+    }
+
+    /*!
+     * Create a sampler of the given \p type
+     * @param seed seed of the render
+     * @param width width of the image
+     * @param samples_per_pixel the number of samples each pixel is expected to take
+     */
+    template<linear_algebra_core::IsFloatingPoint value_type>
+    [[nodiscard]] std::unique_ptr<Sampler_I<value_type>> CreateSampler(SamplerType type, uint64_t seed, size_t width,
+                                                                      size_t samples_per_pixel)
+    {
+        switch(type) {
+            case SamplerType::Random:
+                return std::make_unique<RandomSampler<value_type>>(seed, width);
+            case SamplerType::Stratified:
+                return std::make_unique<StratifiedSampler<value_type>>(seed, width, samples_per_pixel);
+            case SamplerType::Sobol:
+                return std::make_unique<SobolSampler<value_type>>(seed, width);
+            case SamplerType::BlueNoise:
+                return std::make_unique<BlueNoiseSampler<value_type>>(seed);
+        }
+        throw std::invalid_argument("unknown sampler type");
+    }
+}
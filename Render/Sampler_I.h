@@ -0,0 +1,61 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "LinearAlgebraTypeTraits.h"
+
+namespace render
+{
+    /*!
+     * Places the samples of each pixel. Samplers are immutable once built and every point is a pure function of the
+     * pixel and the sample index, so one sampler can be shared by every thread, and a progressive pass can ask for
+     * sample k of a pixel without drawing the ones before it.
+     */
+    template<linear_algebra_core::IsFloatingPoint value_type>
+    class Sampler_I
+    {
+    public:
+        virtual ~Sampler_I() = default;
+
+        /*!
+         * @param x X coordinate of the pixel
+         * @param y Y coordinate of the pixel
+         * @param sample index of the sample within the pixel
+         * @return where in the pixel to take the sample, each coordinate in [0, 1)
+         */
+        [[nodiscard]] virtual std::array<value_type, 2> get(size_t x, size_t y, size_t sample) const = 0;
+    };
+
+    namespace detail
+    {
+        /*!
+         * @return a well mixed 32 bit hash of \p a and \p b (the splitmix64 finalizer)
+         */
+        [[nodiscard]] inline uint32_t hash(uint64_t a, uint64_t b)
+        {
+            uint64_t z = a + (b * 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return static_cast<uint32_t>((z ^ (z >> 31)) >> 32);
+        }
+
+        /*!
+         * @return the 32 bit fixed point fraction \p bits as a value_type in [0, 1), dropping the bits that would make
+         * it round up to 1
+         */
+        template<linear_algebra_core::IsFloatingPoint value_type>
+        [[nodiscard]] value_type toUnit(uint32_t bits)
+        {
+            constexpr int digits = std::min(std::numeric_limits<value_type>::digits, 32);
+            return static_cast<value_type>(bits >> (32 - digits)) / static_cast<value_type>(uint64_t{1} << digits);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Sampler_I.h"
+
+namespace render
+{
+    /*!
+     * The first two dimensions of the Sobol sequence, shuffled and Owen scrambled per pixel. Every power of two prefix
+     * of a pixel's samples is stratified in both dimensions and their product, and scrambling keeps neighbouring
+     * pixels from sharing the same pattern.
+     * @details see "Practical Hash-based Owen Scrambling" (Burley, 2020)
+     */
+    template<linear_algebra_core::IsFloatingPoint value_type>
+    class SobolSampler : public Sampler_I<value_type>
+    {
+    private:
+        uint64_t m_seed;
+        size_t m_width;
+        // the second dimension of every index, one byte of the index at a time: m_second_dimension[i][b] is the xor of
+        // the direction numbers of the bits set in byte i of the index when that byte is b. The first dimension is the
+        // van der Corput sequence, i.e. the reversed bits of the index
+        std::array<std::array<uint32_t, 256>, 4> m_second_dimension{};
+
+        [[nodiscard]] static uint32_t reverseBits(uint32_t x)
+        {
+            x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+            x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+            x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+            x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+            return (x >> 16) | (x << 16);
+        }
+
+        /*!
+         * Hash based approximation of an Owen scramble, applied to the bits of \p x from the highest to the lowest
+         * @details see "Stratified Sampling for Stochastic Transparency" (Laine and Karras, 2011)
+         */
+        [[nodiscard]] static uint32_t nestedUniformScramble(uint32_t x, uint32_t seed)
+        {
+            x = reverseBits(x);
+            x += seed;
+            x ^= x * 0x6c50b47cu;
+            x ^= x * 0xb82f1e52u;
+            x ^= x * 0xc7afe638u;
+            x ^= x * 0x8d22f6e6u;
+            return reverseBits(x);
+        }
+
+    public:
+        /*!
+         * @param seed seed of the render
+         * @param width width of the image, to number the pixels
+         */
+        SobolSampler(uint64_t seed, size_t width) : m_seed(seed), m_width(width)
+        {
+            std::array<uint32_t, 32> directions{};
+            directions[0] = 1u << 31;
+            for(size_t bit = 1; bit < directions.size(); bit++) {
+                directions[bit] = directions[bit - 1] ^ (directions[bit - 1] >> 1);
+            }
+            for(size_t byte = 0; byte < m_second_dimension.size(); byte++) {
+                for(uint32_t value = 0; value < 256; value++) {
+                    for(size_t bit = 0; bit < 8; bit++) {
+                        if((value >> bit) & 1) {
+                            m_second_dimension[byte][value] ^= directions[(byte * 8) + bit];
+                        }
+                    }
+                }
+            }
+        }
+
+        [[nodiscard]] std::array<value_type, 2> get(size_t x, size_t y, size_t sample) const override
+        {
+            uint64_t pixel = (static_cast<uint64_t>(y) * m_width) + x;
+            uint32_t pixel_seed = detail::hash(m_seed, pixel);
+            uint32_t index = nestedUniformScramble(static_cast<uint32_t>(sample), pixel_seed);
+
+            uint32_t u = reverseBits(index);
+            uint32_t v = m_second_dimension[0][index & 0xFF] ^ m_second_dimension[1][(index >> 8) & 0xFF] ^
+                         m_second_dimension[2][(index >> 16) & 0xFF] ^ m_second_dimension[3][index >> 24];
+            u = nestedUniformScramble(u, detail::hash(pixel_seed, 0));
+            v = nestedUniformScramble(v, detail::hash(pixel_seed, 1));
+            return {detail::toUnit<value_type>(u), detail::toUnit<value_type>(v)};
+        }
+    };
+}
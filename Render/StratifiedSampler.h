@@ -0,0 +1,97 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "Sampler_I.h"
+#include "RandomNumberGenerator.h"
+
+namespace render
+{
+    /*!
+     * Jittered stratified samples: the pixel is split into a grid of about samples_per_pixel cells, each sample lands at
+     * a random point of its own cell, and each pixel visits the cells in its own random order so that a render stopped
+     * early still covers the pixel evenly.
+     */
+    template<linear_algebra_core::IsFloatingPoint value_type>
+    class StratifiedSampler : public Sampler_I<value_type>
+    {
+    private:
+        uint64_t m_seed;
+        size_t m_width;
+        uint32_t m_columns;
+        uint32_t m_rows;
+
+        /*!
+         * @return the \p index-th element of a pseudo random permutation of [0, \p length) chosen by \p pattern
+         * @details see "Correlated Multi-Jittered Sampling" (Kensler, 2013)
+         */
+        [[nodiscard]] static uint32_t permute(uint32_t index, uint32_t length, uint32_t pattern)
+        {
+            uint32_t mask = length - 1;
+            mask |= mask >> 1;
+            mask |= mask >> 2;
+            mask |= mask >> 4;
+            mask |= mask >> 8;
+            mask |= mask >> 16;
+            do {
+                index ^= pattern;
+                index *= 0xe170893d;
+                index ^= pattern >> 16;
+                index ^= (index & mask) >> 4;
+                index ^= pattern >> 8;
+                index *= 0x0929eb3f;
+                index ^= pattern >> 23;
+                index ^= (index & mask) >> 1;
+                index *= 1 | pattern >> 27;
+                index *= 0x6935fa69;
+                index ^= (index & mask) >> 11;
+                index *= 0x74dcb303;
+                index ^= (index & mask) >> 2;
+                index *= 0x9e501cc3;
+                index ^= (index & mask) >> 2;
+                index *= 0xc860a3df;
+                index &= mask;
+                index ^= index >> 5;
+            } while(index >= length);
+            return (index + pattern) % length;
+        }
+
+    public:
+        /*!
+         * @param seed seed of the render
+         * @param width width of the image, to number the pixels
+         * @param samples_per_pixel the number of cells to split each pixel into. Later samples start over in a new order
+         */
+        StratifiedSampler(uint64_t seed, size_t width, size_t samples_per_pixel) : m_seed(seed), m_width(width)
+        {
+            m_columns = std::max<uint32_t>(1, static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(samples_per_pixel)))));
+            m_rows = std::max<uint32_t>(1, static_cast<uint32_t>((samples_per_pixel + m_columns - 1) / m_columns));
+        }
+
+        [[nodiscard]] std::array<value_type, 2> get(size_t x, size_t y, size_t sample) const override
+        {
+            uint64_t pixel = (static_cast<uint64_t>(y) * m_width) + x;
+            uint32_t cells = m_columns * m_rows;
+            uint64_t round = sample / cells;
+            uint32_t cell = permute(static_cast<uint32_t>(sample % cells), cells, detail::hash(m_seed + round, pixel));
+
+            utility::RandomStream random(m_seed, pixel);
+            random.discardUniforms<value_type>(2 * sample);
+            value_type jitter_u = random.uniform<value_type>();
+            value_type jitter_v = random.uniform<value_type>();
+            value_type u = (static_cast<value_type>(cell % m_columns) + jitter_u) / static_cast<value_type>(m_columns);
+            value_type v = (static_cast<value_type>(cell / m_columns) + jitter_v) / static_cast<value_type>(m_rows);
+            // the division can round up to exactly 1
+            return {std::min(u, std::nextafter(static_cast<value_type>(1), static_cast<value_type>(0))),
+                    std::min(v, std::nextafter(static_cast<value_type>(1), static_cast<value_type>(0)))};
+        }
+    };
+}
@@ -0,0 +1,225 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace render
+{
+    /*!
+     * A rectangular block of pixels. \p x and \p y are the top left pixel of the tile.
+     */
+    struct Tile
+    {
+        size_t x = 0;
+        size_t y = 0;
+        size_t width = 0;
+        size_t height = 0;
+    };
+
+    /*!
+     * The order tiles are handed out in. Nearby tiles in the order are rendered close together in time, which keeps the
+     * geometry they touch in cache.
+     */
+    enum class TileOrder
+    {
+        Scanline,
+        Morton,
+        Spiral
+    };
+
+    /*!
+     * @param order_name one of "scanline", "morton" or "spiral"
+     * @return the corresponding TileOrder
+     */
+    [[nodiscard]] inline TileOrder TileOrderFromString(const std::string& order_name)
+    {
+        if(order_name == "scanline") {
+            return TileOrder::Scanline;
+        } else if(order_name == "morton") {
+            return TileOrder::Morton;
+        } else if(order_name == "spiral") {
+            return TileOrder::Spiral;
+        }
+        throw std::invalid_argument("tile order must be one of the following values: \n [scanline, morton, spiral]. got " + order_name);
+    }
+
+    /*!
+     * Splits an image into tiles and hands them out to a fixed number of workers. The ordered tile list is split into
+     * one contiguous range per worker; a worker takes tiles from the front of its own range, and once that is empty it
+     * steals the back half of the next non-empty range of another worker. Each range is a single atomic word, so
+     * handing out a tile never takes a lock.
+     */
+    class TileScheduler
+    {
+    private:
+        // a range of tile indices [begin, end), packed as begin in the high 32 bits and end in the low 32 bits
+        struct alignas(64) WorkRange
+        {
+            std::atomic<uint64_t> packed{0};
+        };
+
+        std::vector<Tile> m_tiles;
+        std::unique_ptr<WorkRange[]> m_ranges;
+        size_t m_num_workers = 0;
+
+        [[nodiscard]] static uint64_t pack(uint32_t begin, uint32_t end) { return (static_cast<uint64_t>(begin) << 32) | end; }
+        [[nodiscard]] static uint32_t begin(uint64_t packed) { return static_cast<uint32_t>(packed >> 32); }
+        [[nodiscard]] static uint32_t end(uint64_t packed)   { return static_cast<uint32_t>(packed); }
+
+        /*!
+         * Interleave the bits of \p x and \p y to get the index of the tile along a z-order curve
+         */
+        [[nodiscard]] static uint64_t mortonCode(uint32_t x, uint32_t y)
+        {
+            auto spread = [](uint64_t value) {
+                value = (value | (value << 16)) & 0x0000FFFF0000FFFF;
+                value = (value | (value << 8))  & 0x00FF00FF00FF00FF;
+                value = (value | (value << 4))  & 0x0F0F0F0F0F0F0F0F;
+                value = (value | (value << 2))  & 0x3333333333333333;
+                value = (value | (value << 1))  & 0x5555555555555555;
+                return value;
+            };
+            return spread(x) | (spread(y) << 1);
+        }
+
+        void sortTiles(TileOrder order, size_t tiles_x, size_t tiles_y, size_t tile_size)
+        {
+            switch(order) {
+                case TileOrder::Scanline:
+                    // tiles are generated in scanline order already
+                    break;
+                case TileOrder::Morton:
+                    std::stable_sort(m_tiles.begin(), m_tiles.end(), [tile_size](const Tile& a, const Tile& b) {
+                        return mortonCode(a.x / tile_size, a.y / tile_size) < mortonCode(b.x / tile_size, b.y / tile_size);
+                    });
+                    break;
+                case TileOrder::Spiral: {
+                    // walk outwards from the center one square ring at a time, going around each ring by angle
+                    double center_x = static_cast<double>(tiles_x - 1) / 2.0;
+                    double center_y = static_cast<double>(tiles_y - 1) / 2.0;
+                    auto ring = [=](const Tile& tile) {
+                        return std::max(std::abs(static_cast<double>(tile.x / tile_size) - center_x),
+                                        std::abs(static_cast<double>(tile.y / tile_size) - center_y));
+                    };
+                    auto angle = [=](const Tile& tile) {
+                        return std::atan2(static_cast<double>(tile.y / tile_size) - center_y,
+                                          static_cast<double>(tile.x / tile_size) - center_x);
+                    };
+                    std::stable_sort(m_tiles.begin(), m_tiles.end(), [&](const Tile& a, const Tile& b) {
+                        double ring_a = std::ceil(ring(a));
+                        double ring_b = std::ceil(ring(b));
+                        if(ring_a != ring_b) {
+                            return ring_a < ring_b;
+                        }
+                        return angle(a) < angle(b);
+                    });
+                    break;
+                }
+            }
+        }
+
+        [[nodiscard]] bool popOwn(size_t worker, Tile& tile)
+        {
+            std::atomic<uint64_t>& range = m_ranges[worker].packed;
+            uint64_t current = range.load(std::memory_order_relaxed);
+            while(begin(current) < end(current)) {
+                if(range.compare_exchange_weak(current, pack(begin(current) + 1, end(current)), std::memory_order_acq_rel)) {
+                    tile = m_tiles[begin(current)];
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        [[nodiscard]] bool stealInto(size_t thief)
+        {
+            for(size_t offset = 1; offset < m_num_workers; offset++) {
+                size_t victim = (thief + offset) % m_num_workers;
+                std::atomic<uint64_t>& range = m_ranges[victim].packed;
+                uint64_t current = range.load(std::memory_order_relaxed);
+                while(begin(current) < end(current)) {
+                    uint32_t middle = begin(current) + ((end(current) - begin(current)) / 2);
+                    if(range.compare_exchange_weak(current, pack(begin(current), middle), std::memory_order_acq_rel)) {
+                        // the thief's own range is empty, and nobody else can take from an empty range
+                        m_ranges[thief].packed.store(pack(middle, end(current)), std::memory_order_release);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+    public:
+        TileScheduler() = default;
+        ~TileScheduler() = default;
+        TileScheduler(const TileScheduler& other) = delete;
+        TileScheduler(TileScheduler&& other) noexcept = default;
+        TileScheduler& operator=(const TileScheduler& other) = delete;
+        TileScheduler& operator=(TileScheduler&& other) noexcept = default;
+
+        /*!
+         * Split a \p width by \p height image into tiles and distribute them between \p num_workers workers
+         * @param width width of the image in pixels
+         * @param height height of the image in pixels
+         * @param tile_size width and height of each tile. Tiles on the right and bottom edges may be smaller
+         * @param order the order tiles are handed out in
+         * @param num_workers number of workers that will be calling next()
+         */
+        TileScheduler(size_t width, size_t height, size_t tile_size, TileOrder order, size_t num_workers)
+            : m_num_workers(std::max<size_t>(num_workers, 1))
+        {
+            if(tile_size == 0) {
+                throw std::invalid_argument("tile size must be greater than 0");
+            }
+            size_t tiles_x = (width + tile_size - 1) / tile_size;
+            size_t tiles_y = (height + tile_size - 1) / tile_size;
+            m_tiles.reserve(tiles_x * tiles_y);
+            for(size_t y = 0; y < height; y += tile_size) {
+                for(size_t x = 0; x < width; x += tile_size) {
+                    m_tiles.push_back({x, y, std::min(tile_size, width - x), std::min(tile_size, height - y)});
+                }
+            }
+            sortTiles(order, tiles_x, tiles_y, tile_size);
+
+            m_ranges = std::make_unique<WorkRange[]>(m_num_workers);
+            for(size_t worker = 0; worker < m_num_workers; worker++) {
+                auto range_begin = static_cast<uint32_t>((m_tiles.size() * worker) / m_num_workers);
+                auto range_end = static_cast<uint32_t>((m_tiles.size() * (worker + 1)) / m_num_workers);
+                m_ranges[worker].packed.store(pack(range_begin, range_end), std::memory_order_relaxed);
+            }
+        }
+
+        /*!
+         * Get the next tile for \p worker to render. Safe to call concurrently, as long as each worker index is only
+         * used by one thread at a time.
+         * @param worker index of the calling worker, in [0, number of workers)
+         * @return the next tile, or std::nullopt once every tile has been handed out
+         */
+        [[nodiscard]] std::optional<Tile> next(size_t worker)
+        {
+            Tile tile;
+            do {
+                if(popOwn(worker, tile)) {
+                    return tile;
+                }
+            } while(stealInto(worker));
+            return std::nullopt;
+        }
+
+        /*!
+         * @return every tile, in the order they are handed out
+         */
+        [[nodiscard]] const std::vector<Tile>& getTiles() const { return m_tiles; }
+    };
+}
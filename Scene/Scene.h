@@ -7,6 +7,8 @@
 
 #include "LinearAlgebraTypeTraits.h"
 #include "Ray.h"
+#include "RayPacket.h"
+#include "SimdPack.h"
 #include "Screen.h"
 #include "Camera.h"
 #include "json.h"
@@ -48,6 +50,45 @@ namespace scene {
             return Ray_3(m_camera.getPosition(), m_screen.getPointAt(i, j) - m_camera.getPosition());
         }
 
+        /*!
+         * Packet version of getRayFor. Fills \p packet with the rays through the screen coordinates (\p i[lane],
+         * \p j[lane]) for its first \p count lanes, a simd::Pack of rays at a time. The rays are exactly those getRayFor
+         * gives, but the normalization and inversion of their directions is shared across the pack.
+         * @param i values for the x coordinate of the screen, in [0.0, 1.0]
+         * @param j values for the y coordinate of the screen, in [0.0, 1.0]
+         * @param count number of rays to generate
+         * @param packet the packet to fill in
+         */
+        void getRayPacketFor(const typename RayPacket<value_type>::Lanes& i, const typename RayPacket<value_type>::Lanes& j,
+                             size_t count, RayPacket<value_type>& packet) const
+        {
+            using Pack = simd::Pack<value_type>;
+            const Point_X<3, value_type> position = m_camera.getPosition();
+            const Point_X<3, value_type>& corner = m_screen.getReferenceCorner();
+            const Vector_X<3, value_type>& width = m_screen.getWidth();
+            const Vector_X<3, value_type>& height = m_screen.getHeight();
+            const Pack one = Pack::broadcast(1);
+
+            packet.count = count;
+            for(size_t lane = 0; lane < RayPacket<value_type>::size; lane += Pack::width) {
+                Pack u = Pack::load(&i[lane]);
+                Pack v = Pack::load(&j[lane]);
+                std::array<Pack, 3> direction{Pack::broadcast(0), Pack::broadcast(0), Pack::broadcast(0)};
+                for(size_t axis = 0; axis < 3; axis++) {
+                    direction[axis] = ((Pack::broadcast(corner[axis]) + (Pack::broadcast(width[axis]) * u)) +
+                                       (Pack::broadcast(height[axis]) * v)) - Pack::broadcast(position[axis]);
+                }
+                Pack inverse_magnitude = one / (((direction[0] * direction[0]) + (direction[1] * direction[1])) +
+                                                (direction[2] * direction[2])).sqrt();
+                for(size_t axis = 0; axis < 3; axis++) {
+                    Pack unit_direction = direction[axis] * inverse_magnitude;
+                    unit_direction.store(&packet.direction[axis][lane]);
+                    (one / unit_direction).store(&packet.inverse_direction[axis][lane]);
+                    Pack::broadcast(position[axis]).store(&packet.origin[axis][lane]);
+                }
+            }
+        }
+
         /*!
          * @return the Camera object
          */
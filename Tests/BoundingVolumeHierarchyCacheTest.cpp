@@ -0,0 +1,90 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+// Feeds BoundingVolumeHierarchy::readBinary chains of interior nodes around the depth the build is limited to. A chain
+// deeper than that would overflow the traversal stack, so reading it has to fail like any other damaged cache file.
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "BoundingVolumeHierarchy.h"
+
+using namespace environment;
+
+namespace
+{
+    constexpr size_t max_depth = 64;
+
+    using Hierarchy = BoundingVolumeHierarchy<double>;
+    using Point_3 = Point_X<3, double>;
+
+    /*!
+     * Nodes 0 to depth - 1 are interior, each with its left child right after it and its right child the last node.
+     * Node \p depth is a leaf at that depth
+     */
+    std::vector<char> writeChain(uint32_t depth)
+    {
+        utility::BinaryWriter writer;
+        writer.write<uint64_t>(1);
+        writer.write<uint64_t>(depth + 2);
+        for(uint32_t i = 0; i < depth + 2; i++) {
+            writer.write(Point_3(-1.0, -1.0, -1.0));
+            writer.write(Point_3(1.0, 1.0, 1.0));
+            bool is_leaf = i >= depth;
+            writer.write<uint32_t>(is_leaf ? 0 : depth + 1);
+            writer.write<uint32_t>(is_leaf ? 1 : 0);
+        }
+        std::vector<ElementReference> primitives = {{0, 0}};
+        writer.writeVector<ElementReference>(primitives);
+        return writer.getBytes();
+    }
+
+    bool readChain(uint32_t depth, bool should_load)
+    {
+        std::vector<char> bytes = writeChain(depth);
+        utility::BinaryReader reader(bytes);
+        Hierarchy hierarchy;
+        try {
+            hierarchy.readBinary(reader);
+        } catch(const std::runtime_error& error) {
+            if(should_load) {
+                std::cerr << "depth " << depth << ": " << error.what() << "\n";
+            }
+            return !should_load;
+        }
+        if(!should_load) {
+            std::cerr << "depth " << depth << ": loaded a hierarchy deeper than the traversal stack\n";
+            return false;
+        }
+
+        // every box contains the ray origin, so traversal walks the whole chain
+        Ray<3, double> ray(Point_3(0.0, 0.0, 0.0), Vector_X<3, double>(0.0, 0.0, 1.0));
+        size_t leaves = 0;
+        hierarchy.traverseLeavesUntil(ray, 10.0, [&](uint32_t, uint32_t) {
+            leaves++;
+            return false;
+        });
+        if(leaves != depth + 1) {
+            std::cerr << "depth " << depth << ": visited " << leaves << " leaves, expected " << depth + 1 << "\n";
+            return false;
+        }
+        return true;
+    }
+}
+
+int main()
+{
+    size_t failures = 0;
+    for(uint32_t depth : {1u, 10u, static_cast<uint32_t>(max_depth)}) {
+        failures += !readChain(depth, true);
+    }
+    for(uint32_t depth : {static_cast<uint32_t>(max_depth + 1), 200u}) {
+        failures += !readChain(depth, false);
+    }
+    std::cout << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
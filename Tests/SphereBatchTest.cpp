@@ -0,0 +1,97 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+// Fires random rays at random spheres and checks that SphereBatch finds exactly the same hits as testing every Sphere
+// one at a time. Built once with the SIMD kernels and once with RAY_TRACER_DISABLE_SIMD, see Tests/CMakeLists.txt.
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Sphere.h"
+#include "SphereBatch.h"
+
+using namespace geometry;
+
+namespace
+{
+    constexpr size_t sphere_count = 61;
+    constexpr size_t ray_count = 20000;
+
+    template<IsFloatingPoint value_type>
+    HitRecord<value_type> intersectOneByOne(const std::vector<Sphere<value_type>>& spheres, size_t first, size_t count,
+                                            const Ray<3, value_type>& ray, value_type t_max)
+    {
+        HitRecord<value_type> record;
+        record.t = t_max;
+        for(size_t i = first; i < first + count; i++) {
+            if(spheres[i].intersect(ray, record)) {
+                record.primitive_id = static_cast<uint32_t>(i);
+            }
+        }
+        return record;
+    }
+
+    template<IsFloatingPoint value_type>
+    size_t run(const std::string& name)
+    {
+        using Point_3 = Point_X<3, value_type>;
+        using Vector_3 = Vector_X<3, value_type>;
+
+        std::mt19937_64 generator(12345);
+        std::uniform_real_distribution<value_type> coordinate(-10, 10);
+        std::uniform_real_distribution<value_type> radius(static_cast<value_type>(0.1), 3);
+        std::uniform_int_distribution<size_t> slot(0, sphere_count - 1);
+
+        std::vector<Sphere<value_type>> spheres;
+        SphereBatch<value_type> batch;
+        for(size_t i = 0; i < sphere_count; i++) {
+            spheres.emplace_back(Point_3(coordinate(generator), coordinate(generator), coordinate(generator)),
+                                 radius(generator), color_core::Color());
+            batch.add(spheres.back(), static_cast<uint32_t>(i));
+        }
+
+        size_t failures = 0, hits = 0;
+        for(size_t i = 0; i < ray_count; i++) {
+            Point_3 origin(coordinate(generator), coordinate(generator), coordinate(generator));
+            // aim most rays near a sphere, so plenty of them hit something
+            Point_3 target = spheres[slot(generator)].getCentroid();
+            Vector_3 direction = (target - origin) + Vector_3(coordinate(generator), coordinate(generator), coordinate(generator)) *
+                                                     static_cast<value_type>(0.2);
+            Ray<3, value_type> ray(origin, direction.normalize());
+            // half of the rays are bounded, like a ray that already hit something
+            value_type t_max = i % 2 == 0 ? std::numeric_limits<value_type>::max() : coordinate(generator) + 10;
+
+            // every range, including ones that don't start or end on a multiple of the pack width
+            size_t first = i % 3 == 0 ? 0 : slot(generator);
+            size_t count = i % 3 == 0 ? sphere_count : std::uniform_int_distribution<size_t>(0, sphere_count - first)(generator);
+
+            HitRecord<value_type> expected = intersectOneByOne(spheres, first, count, ray, t_max);
+            HitRecord<value_type> actual;
+            actual.t = t_max;
+            bool updated = batch.intersect(first, count, ray, actual);
+
+            hits += expected.hasHit();
+            if(updated != expected.hasHit() || actual.t != expected.t || actual.primitive_id != expected.primitive_id) {
+                if(failures < 10) {
+                    std::cerr << name << ": ray " << i << " expected t " << expected.t << " id " << expected.primitive_id
+                              << ", got t " << actual.t << " id " << actual.primitive_id << "\n";
+                }
+                failures++;
+            }
+        }
+        std::cout << name << ": " << ray_count << " rays, " << hits << " hits, " << failures << " mismatches ("
+                  << linear_algebra_core::simd::Pack<value_type>::width << " wide)\n";
+        return failures;
+    }
+}
+
+int main()
+{
+    size_t failures = run<float>("float") + run<double>("double");
+    return failures == 0 ? 0 : 1;
+}
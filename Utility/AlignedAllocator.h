@@ -0,0 +1,49 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace utility
+{
+    /*!
+     * Allocator that places the start of every allocation on an \p Alignment byte boundary, i.e. a cache line.
+     * @tparam T type of the elements being allocated
+     * @tparam Alignment required alignment in bytes. Must be a power of two
+     */
+    template<typename T, size_t Alignment = 64>
+    class AlignedAllocator
+    {
+        static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+    public:
+        using value_type = T;
+
+        template<typename U>
+        struct rebind
+        {
+            using other = AlignedAllocator<U, Alignment>;
+        };
+
+        AlignedAllocator() noexcept = default;
+
+        template<typename U>
+        explicit AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept { }
+
+        [[nodiscard]] T* allocate(size_t count)
+        {
+            return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+        }
+
+        void deallocate(T* pointer, size_t) noexcept
+        {
+            ::operator delete(pointer, std::align_val_t{Alignment});
+        }
+
+        template<typename U>
+        bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    };
+}
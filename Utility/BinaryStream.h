@@ -0,0 +1,122 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace utility
+{
+    /*!
+     * Appends values to a byte buffer in the native byte order, for caches that are only read back on the same machine
+     */
+    class BinaryWriter
+    {
+    private:
+        std::vector<char> m_bytes;
+
+    public:
+        template<typename T>
+        void write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be written as bytes");
+            const auto* bytes = reinterpret_cast<const char*>(&value);
+            m_bytes.insert(m_bytes.end(), bytes, bytes + sizeof(T));
+        }
+
+        /*!
+         * Write the size of \p values, followed by its elements
+         */
+        template<typename T>
+        void writeVector(std::span<const T> values)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be written as bytes");
+            write<uint64_t>(values.size());
+            const auto* bytes = reinterpret_cast<const char*>(values.data());
+            m_bytes.insert(m_bytes.end(), bytes, bytes + values.size_bytes());
+        }
+
+        void writeString(const std::string& value)
+        {
+            writeVector<char>(value);
+        }
+
+        [[nodiscard]] const std::vector<char>& getBytes() const { return m_bytes; }
+    };
+
+    /*!
+     * Reads back the values written by a BinaryWriter, checking that they don't run past the end of the buffer
+     */
+    class BinaryReader
+    {
+    private:
+        std::span<const char> m_bytes;
+        size_t m_position = 0;
+
+        void require(size_t size) const
+        {
+            if(size > m_bytes.size() - m_position) {
+                throw std::runtime_error("binary data ends unexpectedly");
+            }
+        }
+
+    public:
+        explicit BinaryReader(std::span<const char> bytes) : m_bytes(bytes) { }
+
+        template<typename T>
+        [[nodiscard]] T read()
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be read as bytes");
+            require(sizeof(T));
+            T value;
+            std::memcpy(&value, m_bytes.data() + m_position, sizeof(T));
+            m_position += sizeof(T);
+            return value;
+        }
+
+        template<typename T>
+        [[nodiscard]] std::vector<T> readVector()
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be read as bytes");
+            auto size = read<uint64_t>();
+            if(size > (m_bytes.size() - m_position) / sizeof(T)) {
+                throw std::runtime_error("binary data ends unexpectedly");
+            }
+            std::vector<T> values(size);
+            std::memcpy(values.data(), m_bytes.data() + m_position, size * sizeof(T));
+            m_position += size * sizeof(T);
+            return values;
+        }
+
+        [[nodiscard]] std::string readString()
+        {
+            std::vector<char> characters = readVector<char>();
+            return {characters.begin(), characters.end()};
+        }
+
+        /*!
+         * @return true if every byte has been read
+         */
+        [[nodiscard]] bool atEnd() const { return m_position == m_bytes.size(); }
+    };
+
+    /*!
+     * 64 bit FNV-1a hash of \p bytes. Not cryptographic, only meant to notice when a file has changed
+     */
+    [[nodiscard]] inline uint64_t hashBytes(std::span<const char> bytes)
+    {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for(char byte : bytes) {
+            hash ^= static_cast<uint8_t>(byte);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+}
@@ -0,0 +1,120 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utility
+{
+    /*!
+     * A read only view of a whole file. On POSIX systems the file is memory mapped, so pages are only read in as they
+     * are touched and never copied. Elsewhere the file is read into memory up front.
+     */
+    class MappedFile
+    {
+    private:
+        const char* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        std::vector<char> m_buffer;
+#endif
+
+        void release()
+        {
+#ifndef _WIN32
+            if(m_data != nullptr && m_size > 0) {
+                munmap(const_cast<char*>(m_data), m_size);
+            }
+#endif
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile& other) = delete;
+        MappedFile& operator=(const MappedFile& other) = delete;
+
+        MappedFile(MappedFile&& other) noexcept
+        {
+            *this = std::move(other);
+        }
+
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            if(this != &other) {
+                release();
+                m_data = std::exchange(other.m_data, nullptr);
+                m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+                m_buffer = std::move(other.m_buffer);
+#endif
+            }
+            return *this;
+        }
+
+        ~MappedFile() { release(); }
+
+        /*!
+         * @param filepath the file to map
+         * @throws std::runtime_error if the file can't be opened or mapped
+         */
+        explicit MappedFile(const std::string& filepath)
+        {
+#ifdef _WIN32
+            std::ifstream in(filepath, std::ios::binary | std::ios::ate);
+            if(!in.is_open()) {
+                throw std::runtime_error("Could not open " + filepath + " for reading");
+            }
+            m_buffer.resize(static_cast<size_t>(in.tellg()));
+            in.seekg(0);
+            in.read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+            m_data = m_buffer.data();
+            m_size = m_buffer.size();
+#else
+            int descriptor = ::open(filepath.c_str(), O_RDONLY);
+            if(descriptor < 0) {
+                throw std::runtime_error("Could not open " + filepath + " for reading");
+            }
+            struct stat status{};
+            if(fstat(descriptor, &status) != 0) {
+                ::close(descriptor);
+                throw std::runtime_error("Could not get the size of " + filepath);
+            }
+            m_size = static_cast<size_t>(status.st_size);
+            if(m_size > 0) {
+                void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+                if(mapping == MAP_FAILED) {
+                    ::close(descriptor);
+                    m_size = 0;
+                    throw std::runtime_error("Could not memory map " + filepath);
+                }
+                // the whole file is about to be read front to back
+                madvise(mapping, m_size, MADV_SEQUENTIAL);
+                m_data = static_cast<const char*>(mapping);
+            }
+            // the mapping stays valid after the descriptor is closed
+            ::close(descriptor);
+#endif
+        }
+
+        [[nodiscard]] const char* data() const { return m_data; }
+        [[nodiscard]] size_t size() const { return m_size; }
+        [[nodiscard]] std::span<const char> bytes() const { return {m_data, m_size}; }
+    };
+}
@@ -0,0 +1,73 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ThreadPool.h"
+
+namespace utility
+{
+    /*!
+     * @return the number of workers of the current ThreadPool, or the number of hardware threads if there is none
+     */
+    [[nodiscard]] inline size_t concurrency()
+    {
+        if(ThreadPool* pool = ThreadPool::Current()) {
+            return pool->size();
+        }
+        return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    /*!
+     * Split [0, \p count) into consecutive ranges, one per worker (see concurrency), but none smaller than \p min_size
+     * @return the [begin, end) of each range. A single empty range if \p count is 0
+     */
+    [[nodiscard]] inline std::vector<std::pair<size_t, size_t>> splitRange(size_t count, size_t min_size)
+    {
+        size_t max_ranges = std::max<size_t>(1, count / std::max<size_t>(min_size, 1));
+        size_t range_count = std::min(concurrency(), max_ranges);
+        std::vector<std::pair<size_t, size_t>> ranges;
+        ranges.reserve(range_count);
+        for(size_t i = 0; i < range_count; i++) {
+            ranges.emplace_back((count * i) / range_count, (count * (i + 1)) / range_count);
+        }
+        return ranges;
+    }
+
+    /*!
+     * Call \p function with every index in [0, \p count) concurrently, and wait for all of them to finish. The first
+     * exception thrown by any call is rethrown once every call is done. Runs on the current ThreadPool if there is one,
+     * otherwise on threads started just for this call.
+     */
+    template<typename Function>
+    void parallelFor(size_t count, Function&& function)
+    {
+        if(count == 1) {
+            function(size_t{0});
+            return;
+        }
+        if(ThreadPool* pool = ThreadPool::Current()) {
+            pool->run(count, function);
+            return;
+        }
+        std::vector<std::future<void>> tasks;
+        tasks.reserve(count);
+        for(size_t i = 0; i < count; i++) {
+            tasks.push_back(std::async(std::launch::async, [&function, i]() { function(i); }));
+        }
+        for(std::future<void>& task : tasks) {
+            task.wait();
+        }
+        for(std::future<void>& task : tasks) {
+            task.get();
+        }
+    }
+}
@@ -3,29 +3,162 @@
 //
 #pragma once
 
-#include <memory>
-#include <random>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
 
 #include "LinearAlgebraTypeTraits.h"
 
 namespace utility {
-    namespace {
-        static __uint128_t randomizer_state;
+
+    /*!
+     * Counter based random number stream using the Philox4x32-10 generator. Every output is a pure function of the
+     * seed, the stream id, and how many numbers have been drawn from the stream, so keying the stream by something
+     * like a pixel index gives the same numbers no matter which thread ends up drawing them. There is no shared
+     * state, so any number of streams can be used concurrently.
+     * @details see "Parallel Random Numbers: As Easy as 1, 2, 3" (Salmon et al., 2011)
+     */
+    class RandomStream
+    {
+    private:
+        static constexpr uint32_t multiplier_0 = 0xD2511F53;
+        static constexpr uint32_t multiplier_1 = 0xCD9E8D57;
+        static constexpr uint32_t key_increment_0 = 0x9E3779B9;
+        static constexpr uint32_t key_increment_1 = 0xBB67AE85;
+
+        std::array<uint32_t, 2> m_key;
+        uint64_t m_stream_id;
+        uint64_t m_counter = 0;
+        std::array<uint32_t, 4> m_block{};
+        // number of values of m_block that have not been handed out yet
+        size_t m_remaining = 0;
+
+        [[nodiscard]] static std::array<uint32_t, 4> generateBlock(std::array<uint32_t, 2> key, uint64_t stream_id, uint64_t counter)
+        {
+            std::array<uint32_t, 4> block{static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32),
+                                          static_cast<uint32_t>(stream_id), static_cast<uint32_t>(stream_id >> 32)};
+            for(int round = 0; round < 10; round++) {
+                uint64_t product_0 = static_cast<uint64_t>(multiplier_0) * block[0];
+                uint64_t product_1 = static_cast<uint64_t>(multiplier_1) * block[2];
+                block = {static_cast<uint32_t>(product_1 >> 32) ^ block[1] ^ key[0], static_cast<uint32_t>(product_1),
+                         static_cast<uint32_t>(product_0 >> 32) ^ block[3] ^ key[1], static_cast<uint32_t>(product_0)};
+                key[0] += key_increment_0;
+                key[1] += key_increment_1;
+            }
+            return block;
+        }
+
+    public:
+        /*!
+         * @param seed seed shared by every stream of a render
+         * @param stream_id identifies this stream, i.e. a pixel index
+         */
+        RandomStream(uint64_t seed, uint64_t stream_id)
+            : m_key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}, m_stream_id(stream_id) { }
+
+        /*!
+         * @return the next 32 random bits of the stream
+         */
+        [[nodiscard]] uint32_t next32()
+        {
+            if(m_remaining == 0) {
+                m_block = generateBlock(m_key, m_stream_id, m_counter++);
+                m_remaining = m_block.size();
+            }
+            return m_block[--m_remaining];
+        }
+
+        /*!
+         * @return the next 64 random bits of the stream
+         */
+        [[nodiscard]] uint64_t next64()
+        {
+            uint64_t high = next32();
+            return (high << 32) | next32();
+        }
+
+        /*!
+         * Skip ahead as if next32 had been called \p count times, without generating the blocks in between
+         */
+        void discard(uint64_t count)
+        {
+            uint64_t from_block = std::min<uint64_t>(count, m_remaining);
+            m_remaining -= from_block;
+            count -= from_block;
+            m_counter += count / m_block.size();
+            for(uint64_t i = 0; i < count % m_block.size(); i++) {
+                static_cast<void>(next32());
+            }
+        }
+
+        /*!
+         * Skip ahead as if uniform<value_type> had been called \p count times
+         */
+        template<linear_algebra_core::IsFloatingPoint value_type>
+        void discardUniforms(uint64_t count)
+        {
+            constexpr uint64_t words_per_uniform = std::numeric_limits<value_type>::digits <= 32 ? 1 : 2;
+            discard(count * words_per_uniform);
+        }
+
+        /*!
+         * @return a uniformly distributed number in [0, 1)
+         */
+        template<linear_algebra_core::IsFloatingPoint value_type>
+        [[nodiscard]] value_type uniform()
+        {
+            // only take as many bits as the mantissa can hold, so the result can never round up to 1
+            if constexpr (std::numeric_limits<value_type>::digits <= 32) {
+                constexpr int shift = 32 - std::numeric_limits<value_type>::digits;
+                return static_cast<value_type>(next32() >> shift) / static_cast<value_type>(uint64_t{1} << (32 - shift));
+            } else {
+                return static_cast<value_type>(next64() >> 11) * static_cast<value_type>(0x1.0p-53);
+            }
+        }
+
+        /*!
+         * @return a uniformly distributed number in [\p low, \p high)
+         */
+        template<linear_algebra_core::IsFloatingPoint value_type>
+        [[nodiscard]] value_type uniform(value_type low, value_type high)
+        {
+            return low + ((high - low) * uniform<value_type>());
+        }
+    };
+
+    namespace detail {
+        inline std::atomic<uint64_t> randomizer_seed{0};
+        inline std::atomic<uint64_t> next_thread_stream{0};
+    }
+
+    /*!
+     * Set the seed used by get_random_number. Threads that have already drawn a number keep their current stream.
+     * @param initial_state the new seed
+     */
+    inline void initialize_randomizer(uint64_t initial_state)
+    {
+        detail::randomizer_seed = initial_state;
     }
-    void initialize_randomizer(uint64_t initial_state)
+
+    /*!
+     * @return the seed set by initialize_randomizer
+     */
+    [[nodiscard]] inline uint64_t get_randomizer_seed()
     {
-        randomizer_state = initial_state;
+        return detail::randomizer_seed;
     }
 
+    /*!
+     * Draw a number from the calling thread's own stream. Safe to call from any thread, but which numbers a caller sees
+     * depends on thread scheduling; use a RandomStream keyed by the work item when the results need to be reproducible.
+     * @return a uniformly distributed number in [\p low, \p high)
+     */
     template<linear_algebra_core::IsFloatingPoint value_type>
     value_type get_random_number(value_type low, value_type high)
     {
-        uint64_t temp;
-        {
-            randomizer_state *= 0xda942042e4dd58b5;
-            temp = randomizer_state >> 64;
-        }
-        value_type t = static_cast<value_type>(temp) / static_cast<value_type>(std::numeric_limits<uint64_t>::max());
-        return low + ((high - low) * t);
+        thread_local RandomStream stream(detail::randomizer_seed, detail::next_thread_stream++);
+        return stream.uniform(low, high);
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,222 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "json.h"
+
+namespace utility
+{
+    // configure with -DRAY_TRACER_STATISTICS=OFF to compile every counter out
+#ifdef RAY_TRACER_DISABLE_STATISTICS
+    inline constexpr bool statistics_enabled = false;
+#else
+    inline constexpr bool statistics_enabled = true;
+#endif
+
+    /*!
+     * Events counted while rendering
+     */
+    enum class Counter : size_t
+    {
+        PrimaryRays,
+        Hits,
+        BackgroundMisses,
+        SphereTests,
+        PlaneTests,
+        BoundedPlaneTests,
+        TriangleTests,
+        NumberOfCounters
+    };
+
+    inline constexpr size_t number_of_counters = static_cast<size_t>(Counter::NumberOfCounters);
+
+    inline constexpr std::array<const char*, number_of_counters> counter_names = {
+        "primary_rays", "hits", "background_misses", "sphere_tests", "plane_tests", "bounded_plane_tests", "triangle_tests"
+    };
+
+    /*!
+     * Counters of a single thread. Aligned to a cache line so threads never share one.
+     */
+    struct alignas(64) ThreadStatistics
+    {
+        std::array<uint64_t, number_of_counters> counters{};
+        // time spent working, as opposed to waiting for work
+        std::chrono::nanoseconds busy_time{0};
+
+        [[nodiscard]] uint64_t get(Counter counter) const { return counters[static_cast<size_t>(counter)]; }
+
+        ThreadStatistics& operator+=(const ThreadStatistics& other)
+        {
+            for(size_t i = 0; i < counters.size(); i++) {
+                counters[i] += other.counters[i];
+            }
+            busy_time += other.busy_time;
+            return *this;
+        }
+    };
+
+    namespace detail {
+        inline thread_local ThreadStatistics thread_statistics;
+    }
+
+    /*!
+     * Add \p amount to the calling thread's \p counter. Compiles to nothing when statistics are disabled.
+     */
+    inline void count(Counter counter, uint64_t amount = 1)
+    {
+        if constexpr (statistics_enabled) {
+            detail::thread_statistics.counters[static_cast<size_t>(counter)] += amount;
+        }
+    }
+
+    /*!
+     * Add \p time to the calling thread's busy time. Compiles to nothing when statistics are disabled.
+     */
+    inline void addBusyTime(std::chrono::nanoseconds time)
+    {
+        if constexpr (statistics_enabled) {
+            detail::thread_statistics.busy_time += time;
+        }
+    }
+
+    /*!
+     * @return the calling thread's counters, which are reset to zero
+     */
+    [[nodiscard]] inline ThreadStatistics takeThreadStatistics()
+    {
+        ThreadStatistics result = detail::thread_statistics;
+        detail::thread_statistics = {};
+        return result;
+    }
+
+    /*!
+     * The counters of every thread that took part in a render, and how long the render took
+     */
+    class RenderStatistics
+    {
+    private:
+        std::vector<ThreadStatistics> m_threads;
+        std::chrono::nanoseconds m_wall_time{0};
+
+        [[nodiscard]] static double toSeconds(std::chrono::nanoseconds time)
+        {
+            return std::chrono::duration<double>(time).count();
+        }
+
+    public:
+        RenderStatistics() = default;
+        ~RenderStatistics() = default;
+        RenderStatistics(const RenderStatistics& other) = default;
+        RenderStatistics(RenderStatistics&& other) noexcept = default;
+        RenderStatistics& operator=(const RenderStatistics& other) = default;
+        RenderStatistics& operator=(RenderStatistics&& other) noexcept = default;
+
+        /*!
+         * @param threads the counters of each thread
+         * @param wall_time how long the render took from start to finish
+         */
+        RenderStatistics(std::vector<ThreadStatistics> threads, std::chrono::nanoseconds wall_time)
+            : m_threads(std::move(threads)), m_wall_time(wall_time) { }
+
+        /*!
+         * @return the sum of \p counter over every thread
+         */
+        [[nodiscard]] uint64_t getTotal(Counter counter) const
+        {
+            uint64_t total = 0;
+            for(const ThreadStatistics& thread : m_threads) {
+                total += thread.get(counter);
+            }
+            return total;
+        }
+
+        /*!
+         * @return the number of intersection tests against any type of primitive
+         */
+        [[nodiscard]] uint64_t getTotalIntersectionTests() const
+        {
+            return getTotal(Counter::SphereTests) + getTotal(Counter::PlaneTests) +
+                   getTotal(Counter::BoundedPlaneTests) + getTotal(Counter::TriangleTests);
+        }
+
+        /*!
+         * @return the busiest thread's busy time divided by the average busy time. 1 is a perfect balance
+         */
+        [[nodiscard]] double getLoadImbalance() const
+        {
+            if(m_threads.empty()) {
+                return 1.0;
+            }
+            std::chrono::nanoseconds total{0}, longest{0};
+            for(const ThreadStatistics& thread : m_threads) {
+                total += thread.busy_time;
+                longest = std::max(longest, thread.busy_time);
+            }
+            if(total.count() == 0) {
+                return 1.0;
+            }
+            return toSeconds(longest) / (toSeconds(total) / static_cast<double>(m_threads.size()));
+        }
+
+        [[nodiscard]] const std::vector<ThreadStatistics>& getThreads() const { return m_threads; }
+        [[nodiscard]] std::chrono::nanoseconds getWallTime() const { return m_wall_time; }
+
+        /*!
+         * @return the totals, derived rates, and per thread counters as a json object
+         */
+        [[nodiscard]] nlohmann::json toJson() const
+        {
+            nlohmann::json result;
+            result["wall_time_seconds"] = toSeconds(m_wall_time);
+            for(size_t i = 0; i < number_of_counters; i++) {
+                result["totals"][counter_names[i]] = getTotal(static_cast<Counter>(i));
+            }
+            result["totals"]["intersection_tests"] = getTotalIntersectionTests();
+            double seconds = std::max(toSeconds(m_wall_time), 1e-9);
+            result["primary_rays_per_second"] = static_cast<double>(getTotal(Counter::PrimaryRays)) / seconds;
+            result["intersection_tests_per_second"] = static_cast<double>(getTotalIntersectionTests()) / seconds;
+            result["load_imbalance"] = getLoadImbalance();
+            result["threads"] = nlohmann::json::array();
+            for(const ThreadStatistics& thread : m_threads) {
+                nlohmann::json thread_json;
+                for(size_t i = 0; i < number_of_counters; i++) {
+                    thread_json[counter_names[i]] = thread.counters[i];
+                }
+                thread_json["busy_time_seconds"] = toSeconds(thread.busy_time);
+                result["threads"].push_back(thread_json);
+            }
+            return result;
+        }
+
+        /*!
+         * @return a short human readable summary of the render
+         */
+        [[nodiscard]] std::string getSummary() const
+        {
+            double seconds = std::max(toSeconds(m_wall_time), 1e-9);
+            uint64_t primary_rays = getTotal(Counter::PrimaryRays);
+            uint64_t tests = getTotalIntersectionTests();
+            std::ostringstream summary;
+            summary << "render statistics (" << m_threads.size() << " threads, " << seconds << " s)\n"
+                    << "  primary rays:       " << primary_rays << " (" << static_cast<double>(primary_rays) / seconds / 1e6 << " M/s)\n"
+                    << "  hits / misses:      " << getTotal(Counter::Hits) << " / " << getTotal(Counter::BackgroundMisses) << "\n"
+                    << "  intersection tests: " << tests << " (" << static_cast<double>(tests) / std::max<double>(static_cast<double>(primary_rays), 1.0) << " per ray)\n"
+                    << "    spheres:          " << getTotal(Counter::SphereTests) << "\n"
+                    << "    planes:           " << getTotal(Counter::PlaneTests) << "\n"
+                    << "    bounded planes:   " << getTotal(Counter::BoundedPlaneTests) << "\n"
+                    << "    triangles:        " << getTotal(Counter::TriangleTests) << "\n"
+                    << "  load imbalance:     " << getLoadImbalance() << " (busiest thread / average)\n";
+            return summary.str();
+        }
+    };
+}
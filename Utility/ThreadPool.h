@@ -0,0 +1,338 @@
+//
+// Created by olber on 10/18/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "json.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace utility
+{
+    /*!
+     * A fixed set of worker threads that live as long as the pool, so parallel work doesn't pay for creating and joining
+     * threads every time. Work is submitted as a job of \p count indices with run, which blocks until every index is
+     * done. Workers can optionally be pinned to one core each, and the pool keeps track of how busy each worker is.
+     *
+     * Code that doesn't have a pool at hand, e.g. the mesh parsers, finds one with Current: either the pool of the worker
+     * it is running on, or the pool installed on the calling thread with a Scope.
+     */
+    class ThreadPool
+    {
+    public:
+        /*!
+         * What a single worker has done since the pool was created
+         */
+        struct WorkerStatistics
+        {
+            // time spent running jobs, as opposed to waiting for them
+            std::chrono::nanoseconds busy_time{0};
+            // the number of job indices run
+            uint64_t tasks = 0;
+        };
+
+        /*!
+         * Makes a pool the Current one on the calling thread for as long as the scope lives
+         */
+        class Scope
+        {
+        private:
+            ThreadPool* m_previous;
+
+        public:
+            explicit Scope(ThreadPool& pool) : m_previous(s_scoped_pool) { s_scoped_pool = &pool; }
+            ~Scope() { s_scoped_pool = m_previous; }
+            Scope(const Scope& other) = delete;
+            Scope(Scope&& other) noexcept = delete;
+            Scope& operator=(const Scope& other) = delete;
+            Scope& operator=(Scope&& other) noexcept = delete;
+        };
+
+    private:
+        struct Job
+        {
+            std::function<void(size_t)> function;
+            size_t count = 0;
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> remaining{0};
+            std::mutex exception_mutex;
+            std::exception_ptr exception;
+        };
+
+        // written only by its own worker, read by anyone, so each gets its own cache line
+        struct alignas(64) Worker
+        {
+            std::atomic<int64_t> busy_nanoseconds{0};
+            std::atomic<uint64_t> tasks{0};
+        };
+
+        std::vector<Worker> m_workers;
+        std::vector<std::thread> m_threads;
+        std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+        bool m_pinned = false;
+
+        std::mutex m_mutex;
+        std::condition_variable m_work_available;
+        std::condition_variable m_job_done;
+        std::deque<std::shared_ptr<Job>> m_jobs;
+        bool m_stopping = false;
+
+        static inline thread_local ThreadPool* s_worker_pool = nullptr;
+        static inline thread_local size_t s_worker_index = 0;
+        static inline thread_local ThreadPool* s_scoped_pool = nullptr;
+
+        /*!
+         * Pin the calling thread to the core \p worker_index, wrapping around the number of cores
+         * @return true if the thread was pinned
+         */
+        static bool pinToCore(size_t worker_index)
+        {
+#ifdef __linux__
+            size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            CPU_SET(worker_index % cores, &cpu_set);
+            return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+            return false;
+#endif
+        }
+
+        /*!
+         * Claim the next index of the \p job and run it on the worker \p worker_index
+         * @return false if every index of the \p job has already been claimed
+         */
+        bool runNext(Job& job, size_t worker_index)
+        {
+            size_t index = job.next.fetch_add(1);
+            if(index >= job.count) {
+                return false;
+            }
+            auto start = std::chrono::steady_clock::now();
+            try {
+                job.function(index);
+            } catch(...) {
+                std::lock_guard lock(job.exception_mutex);
+                if(!job.exception) {
+                    job.exception = std::current_exception();
+                }
+            }
+            Worker& worker = m_workers[worker_index];
+            worker.busy_nanoseconds.fetch_add(std::chrono::nanoseconds(std::chrono::steady_clock::now() - start).count(),
+                                              std::memory_order_relaxed);
+            worker.tasks.fetch_add(1, std::memory_order_relaxed);
+
+            if(job.remaining.fetch_sub(1) == 1) {
+                // notified under the lock, so a waiter can't miss it between checking and going to sleep
+                std::lock_guard lock(m_mutex);
+                m_job_done.notify_all();
+            }
+            return true;
+        }
+
+        void work(size_t worker_index, bool pin)
+        {
+            s_worker_pool = this;
+            s_worker_index = worker_index;
+            if(pin && !pinToCore(worker_index)) {
+                std::lock_guard lock(m_mutex);
+                m_pinned = false;
+            }
+
+            while(true) {
+                std::shared_ptr<Job> job;
+                {
+                    std::unique_lock lock(m_mutex);
+                    m_work_available.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+                    if(m_jobs.empty()) {
+                        return;
+                    }
+                    job = m_jobs.front();
+                }
+                while(runNext(*job, worker_index)) { }
+                {
+                    std::lock_guard lock(m_mutex);
+                    std::erase(m_jobs, job);
+                }
+            }
+        }
+
+    public:
+        /*!
+         * Start the workers
+         * @param thread_count the number of workers, at least 1
+         * @param pin_threads pin worker i to core i, wrapping around the number of cores. Only supported on Linux
+         */
+        explicit ThreadPool(size_t thread_count, bool pin_threads = false)
+            : m_workers(std::max<size_t>(thread_count, 1)), m_pinned(pin_threads)
+        {
+#ifndef __linux__
+            m_pinned = false;
+#endif
+            m_threads.reserve(m_workers.size());
+            for(size_t i = 0; i < m_workers.size(); i++) {
+                m_threads.emplace_back(&ThreadPool::work, this, i, pin_threads);
+            }
+        }
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                m_stopping = true;
+            }
+            m_work_available.notify_all();
+            for(std::thread& thread : m_threads) {
+                thread.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool& other) = delete;
+        ThreadPool(ThreadPool&& other) noexcept = delete;
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+        ThreadPool& operator=(ThreadPool&& other) noexcept = delete;
+
+        /*!
+         * @return the pool of the worker the caller is running on, otherwise the pool of the innermost Scope on the
+         * calling thread, otherwise nullptr
+         */
+        [[nodiscard]] static ThreadPool* Current()
+        {
+            return s_worker_pool != nullptr ? s_worker_pool : s_scoped_pool;
+        }
+
+        /*!
+         * Call \p function with every index in [0, \p count) on the workers, and wait for all of them to finish. The
+         * first exception thrown by any call is rethrown once every call is done. When called from one of this pool's
+         * own workers, that worker helps run the indices rather than waiting idle, so jobs can be nested.
+         */
+        template<typename Function>
+        void run(size_t count, Function&& function)
+        {
+            if(count == 0) {
+                return;
+            }
+            auto job = std::make_shared<Job>();
+            job->function = [&function](size_t index) { function(index); };
+            job->count = count;
+            job->remaining = count;
+            {
+                std::lock_guard lock(m_mutex);
+                m_jobs.push_back(job);
+            }
+            m_work_available.notify_all();
+
+            if(s_worker_pool == this) {
+                while(runNext(*job, s_worker_index)) { }
+            }
+            {
+                std::unique_lock lock(m_mutex);
+                m_job_done.wait(lock, [&job]() { return job->remaining == 0; });
+            }
+            if(job->exception) {
+                std::rethrow_exception(job->exception);
+            }
+        }
+
+        /*!
+         * @return the number of workers
+         */
+        [[nodiscard]] size_t size() const { return m_workers.size(); }
+
+        /*!
+         * @return true if every worker was pinned to a core
+         */
+        [[nodiscard]] bool isPinned()
+        {
+            std::lock_guard lock(m_mutex);
+            return m_pinned;
+        }
+
+        /*!
+         * @return how long the pool has existed
+         */
+        [[nodiscard]] std::chrono::nanoseconds getUptime() const { return std::chrono::steady_clock::now() - m_start; }
+
+        /*!
+         * @return what each worker has done so far
+         */
+        [[nodiscard]] std::vector<WorkerStatistics> getWorkerStatistics() const
+        {
+            std::vector<WorkerStatistics> result;
+            result.reserve(m_workers.size());
+            for(const Worker& worker : m_workers) {
+                result.push_back({std::chrono::nanoseconds(worker.busy_nanoseconds.load(std::memory_order_relaxed)),
+                                  worker.tasks.load(std::memory_order_relaxed)});
+            }
+            return result;
+        }
+
+        /*!
+         * @return the fraction of the pool's uptime each worker has spent running jobs
+         */
+        [[nodiscard]] std::vector<double> getUtilization() const
+        {
+            double uptime = std::max(std::chrono::duration<double>(getUptime()).count(), 1e-9);
+            std::vector<double> result;
+            for(const WorkerStatistics& worker : getWorkerStatistics()) {
+                result.push_back(std::chrono::duration<double>(worker.busy_time).count() / uptime);
+            }
+            return result;
+        }
+
+        /*!
+         * @return the uptime and each worker's busy time, tasks and utilization as a json object
+         */
+        [[nodiscard]] nlohmann::json toJson()
+        {
+            nlohmann::json result;
+            result["uptime_seconds"] = std::chrono::duration<double>(getUptime()).count();
+            result["pinned"] = isPinned();
+            result["workers"] = nlohmann::json::array();
+            std::vector<WorkerStatistics> workers = getWorkerStatistics();
+            std::vector<double> utilization = getUtilization();
+            for(size_t i = 0; i < workers.size(); i++) {
+                nlohmann::json worker_json;
+                worker_json["busy_time_seconds"] = std::chrono::duration<double>(workers[i].busy_time).count();
+                worker_json["tasks"] = workers[i].tasks;
+                worker_json["utilization"] = utilization[i];
+                result["workers"].push_back(worker_json);
+            }
+            return result;
+        }
+
+        /*!
+         * @return a one line human readable summary of each worker's utilization
+         */
+        [[nodiscard]] std::string getSummary()
+        {
+            std::ostringstream summary;
+            summary << "  worker utilization: ";
+            for(double utilization : getUtilization()) {
+                summary << static_cast<int>(utilization * 100.0 + 0.5) << "% ";
+            }
+            summary << "(" << size() << " workers" << (isPinned() ? ", pinned" : "") << ")\n";
+            return summary.str();
+        }
+    };
+}
@@ -1,32 +1,136 @@
 #include <thread>
 #include <chrono>
+#include <filesystem>
+#include <optional>
 #include "Color.h"
 #include "ImageWriter_I.h"
 #include "ImageWriterBuilder.h"
 #include "ArgParse.h"
 #include "RayTracer.h"
 #include "RandomNumberGenerator.h"
+#include "SceneCache.h"
+#include "EnvironmentStreamParser.h"
+#include "MappedFile.h"
 
 using namespace output;
 using namespace color_core;
 using namespace linear_algebra_core;
 using namespace geometry;
 
-std::string getSuffix(const std::string& file_path) {
-    return file_path.substr(file_path.find_last_of('.') + 1);
-}
-
 struct RayTracerArgs : public argparse::Args {
     std::string &output_config = kwarg("o,output", "The config file for the output image(s)");
     std::string &scene_config = kwarg("s,scene", "The config file for the scene (i.e. camera, viewport, etc.)");
     std::string &environment_config = kwarg("e,environment", "config file defining all the scene geometry and the environment");
     std::string &ray_tracer_parameters = kwarg("p,parameters", "config file containing all the ray tracer parameters");
+    bool &benchmark = flag("b,benchmark", "render the scene in both float and double precision and compare their throughput, without writing the image");
 };
 
+/*!
+ * Build the environment from its config, or load it from the scene cache named by the "scene_cache" ray tracer
+ * parameter when that cache was written from the same config. A freshly built environment is written to the cache.
+ * With the "stream_environment" ray tracer parameter set, the config is parsed one geometry entry at a time rather than
+ * into a json DOM of the whole file.
+ * @param environment_config_path the environment config file
+ */
+template<IsFloatingPoint value_type>
+environment::Environment<value_type> loadEnvironment(const std::string& environment_config_path,
+                                                     const nlohmann::json& ray_tracer_parameter_json)
+{
+    using SceneCache = environment::SceneCache<value_type>;
+    if(!std::filesystem::is_regular_file(environment_config_path)) {
+        return environment::Environment<value_type>(nlohmann::json());
+    }
+    // mapped rather than read, so neither the cache nor the parsers need their own copy of the text
+    utility::MappedFile environment_file(environment_config_path);
+    const char* first = environment_file.data();
+    const char* last = first + environment_file.size();
+
+    std::optional<std::string> cache_path;
+    uint64_t config_hash = 0;
+    if(ray_tracer_parameter_json.contains("scene_cache")) {
+        cache_path = ray_tracer_parameter_json.at("scene_cache").get<std::string>();
+        config_hash = utility::hashBytes(environment_file.bytes());
+        std::optional<environment::Environment<value_type>> cached = SceneCache::Load(*cache_path, config_hash);
+        if(cached.has_value()) {
+            std::cout << "loaded the environment from the scene cache " << *cache_path << std::endl;
+            return std::move(*cached);
+        }
+    }
+
+    environment::Environment<value_type> environment;
+    std::vector<std::string> dependencies;
+    if(ray_tracer_parameter_json.contains("stream_environment") && ray_tracer_parameter_json.at("stream_environment").get<bool>()) {
+        auto parsed = environment::EnvironmentStreamParser<value_type>::Parse(first, last);
+        environment = std::move(parsed.environment);
+        dependencies = std::move(parsed.mesh_files);
+    } else {
+        nlohmann::json environment_json = nlohmann::json::parse(first, last);
+        environment = environment::Environment<value_type>(environment_json);
+        dependencies = SceneCache::FindDependencies(environment_json);
+    }
+
+    if(cache_path.has_value()) {
+        if(SceneCache::Save(*cache_path, config_hash, environment, dependencies)) {
+            std::cout << "wrote the environment to the scene cache " << *cache_path << std::endl;
+        } else {
+            std::cout << "could not write the environment to the scene cache " << *cache_path << std::endl;
+        }
+    }
+    return environment;
+}
+
+/*!
+ * Trace the scene at the precision given by \p value_type and write out the image. Prints the time taken to trace
+ * and the resulting throughput.
+ * @param write_image write the image, and any previews asked for, to the output file
+ * @return the throughput in million primary rays per second
+ */
+template<IsFloatingPoint value_type>
+double renderScene(const std::string& environment_config_path, const nlohmann::json& scene_json,
+                   const nlohmann::json& output_json, const nlohmann::json& ray_tracer_parameter_json, bool write_image = true)
+{
+    RayTracer<value_type> tracer([&]() { return loadEnvironment<value_type>(environment_config_path, ray_tracer_parameter_json); },
+                                 scene_json, output_json, ray_tracer_parameter_json);
+    std::string output_file_path = output_json.at("file_path").get<std::string>();
+    std::unique_ptr<ImageWriter_I> image_writer = ImageWriterBuilder::createWriter(output_json);
+    // progressive renders can overwrite the output after every pass, so it can be watched as it converges
+    if(write_image && ray_tracer_parameter_json.contains("write_previews") && ray_tracer_parameter_json.at("write_previews").get<bool>()) {
+        tracer.setPassCallback([&](const Image&, size_t) { tracer.writeImage(*image_writer, output_file_path); });
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    tracer.trace();
+    auto end = std::chrono::high_resolution_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << elapsed << std::endl;
+
+    // progressive renders may stop early, and adaptive sampling skips converged pixels
+    auto primary_rays = static_cast<double>(tracer.getSamplesTaken());
+    double throughput = primary_rays / std::max<double>(static_cast<double>(elapsed), 1.0) / 1000.0;
+    std::cout << sizeof(value_type) * 8 << " bit precision: " << throughput << " million primary rays/s" << std::endl;
+
+    if(write_image) {
+        tracer.writeImage(*image_writer, output_file_path);
+    }
+    return throughput;
+}
+
+/*!
+ * Render the same scene with RayTracer<float> and then RayTracer<double>, and report the throughput of each. Only
+ * tracing is timed, not loading the environment. Nothing is written, so the output config only sets the image size.
+ */
+void benchmarkPrecisions(const std::string& environment_config_path, const nlohmann::json& scene_json,
+                         const nlohmann::json& output_json, const nlohmann::json& ray_tracer_parameter_json)
+{
+    double float_throughput = renderScene<float>(environment_config_path, scene_json, output_json, ray_tracer_parameter_json, false);
+    double double_throughput = renderScene<double>(environment_config_path, scene_json, output_json, ray_tracer_parameter_json, false);
+    std::cout << "float: " << float_throughput << " million primary rays/s, double: " << double_throughput
+              << " million primary rays/s, float/double: " << float_throughput / std::max(double_throughput, 1e-9) << std::endl;
+}
+
 int main(int argc, char** argv)
 {
     auto args = argparse::parse<RayTracerArgs>(argc, argv);
-    nlohmann::json output_json, scene_json, environment_json, ray_tracer_parameter_json;
+    nlohmann::json output_json, scene_json, ray_tracer_parameter_json;
     {
         std::ifstream output_config_file(args.output_config);
         if(output_config_file.is_open()) {
@@ -38,11 +142,6 @@ int main(int argc, char** argv)
             scene_config_file >> scene_json;
         }
 
-        std::ifstream environment_config_file(args.environment_config);
-        if(environment_config_file.is_open()) {
-            environment_config_file >> environment_json;
-        }
-
         std::ifstream ray_tracer_parameter_config_file(args.ray_tracer_parameters);
         if(ray_tracer_parameter_config_file.is_open()) {
             ray_tracer_parameter_config_file >> ray_tracer_parameter_json;
@@ -50,17 +149,22 @@ int main(int argc, char** argv)
     }
     utility::initialize_randomizer(std::chrono::high_resolution_clock::now().time_since_epoch().count());
 
-    RayTracer<double> tracer(environment_json, scene_json, output_json, ray_tracer_parameter_json);
-    auto start = std::chrono::high_resolution_clock::now();
-    tracer.trace();
-    auto end = std::chrono::high_resolution_clock::now();
-    std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
-
+    if(args.benchmark) {
+        benchmarkPrecisions(args.environment_config, scene_json, output_json, ray_tracer_parameter_json);
+        return 0;
+    }
 
-    std::string output_file_path = output_json.at("file_path").get<std::string>();
-    std::unique_ptr<ImageWriter_I> image_writer = ImageWriterBuilder::createWriter(getSuffix(output_file_path));
-    image_writer->write(tracer.getImage(), output_file_path);
+    std::string precision = "double";
+    if(ray_tracer_parameter_json.contains("precision")) {
+        precision = ray_tracer_parameter_json.at("precision").get<std::string>();
+    }
+    if(precision == "float") {
+        renderScene<float>(args.environment_config, scene_json, output_json, ray_tracer_parameter_json);
+    } else if(precision == "double") {
+        renderScene<double>(args.environment_config, scene_json, output_json, ray_tracer_parameter_json);
+    } else {
+        throw std::invalid_argument("precision must be one of the following values: \n [float, double]. got " + precision);
+    }
 
     return 0;
 }
-